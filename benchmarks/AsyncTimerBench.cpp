@@ -0,0 +1,458 @@
+#include <benchmark/benchmark.h>
+#include <AsyncTimer.h>
+#include <LocalTimer.h>
+#include <ShardedAsyncTimer.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Запуск с сохранением результатов в JSON:
+// ./x64-linux/bin/benchmarks/async_timer_bench --benchmark_out=bench.json --benchmark_out_format=json
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    const uint64_t FAR_NS = 3'600'000'000'000; ///< Таймеры, которые не истекают за время замера
+    const uint32_t REFILL = 1024;               ///< Количество операций между паузами на восстановление размера очереди
+
+    TimerBackend backendArg(const benchmark::State &state) { return static_cast<TimerBackend>(state.range(1)); }
+
+    void queueArgs(benchmark::internal::Benchmark *b)
+    {
+        for (int64_t backend : {static_cast<int64_t>(TimerBackend::Heap), static_cast<int64_t>(TimerBackend::Wheel)})
+            for (int64_t size : {1'000, 10'000, 100'000, 1'000'000})
+                b->Args({size, backend});
+        b->ArgNames({"size", "backend"});
+    }
+
+    /// Однопоточный таймер без статистики и виртуальных вызовов очереди
+    template <typename Backend>
+    struct LocalPolicy
+    {
+        static constexpr uint32_t max_timers = 0;
+        static constexpr bool concurrent = false;
+        static constexpr bool stats = false;
+        using Clock = SteadyClock;
+        using Queue = Backend;
+    };
+
+    template <typename Timer>
+    std::vector<uint64_t> fill(Timer &at, uint32_t count, std::mt19937_64 &gen)
+    {
+        std::uniform_int_distribution<uint64_t> distrib(FAR_NS, 2 * FAR_NS);
+        std::vector<uint64_t> ids;
+        ids.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+            ids.push_back(at.createNanoTimer(distrib(gen), {}).id);
+        return ids;
+    }
+} // namespace
+
+/**
+ * @brief Вставка таймера в очередь размера size
+ *
+ */
+template <typename Timer>
+static void insert(benchmark::State &state, uint32_t segment_size = 0)
+{
+    const uint32_t size = static_cast<uint32_t>(state.range(0));
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<uint64_t> distrib(FAR_NS, 2 * FAR_NS);
+    Timer at(size + REFILL, 1, backendArg(state), {}, ClockSource::Steady, segment_size);
+    fill(at, size, gen);
+    std::vector<uint64_t> ids;
+    ids.reserve(REFILL);
+    for (auto _ : state)
+    {
+        ids.push_back(at.createNanoTimer(distrib(gen), {}).id);
+        if (ids.size() == REFILL)
+        {
+            state.PauseTiming();
+            at.deleteTimers(ids.data(), ids.size());
+            ids.clear();
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_Insert(benchmark::State &state) { insert<AsyncTimer>(state); }
+BENCHMARK(BM_Insert)->Apply(queueArgs);
+
+/**
+ * @brief Вставка таймера с политикой LocalPolicy (очередь выбрана при компиляции), для сравнения с BM_Insert
+ *
+ */
+static void BM_InsertPolicy(benchmark::State &state)
+{
+    if (backendArg(state) == TimerBackend::Wheel)
+        insert<BasicAsyncTimer<LocalPolicy<TimingWheel>>>(state);
+    else
+        insert<BasicAsyncTimer<LocalPolicy<HeapTimerQueue>>>(state);
+}
+BENCHMARK(BM_InsertPolicy)->Apply(queueArgs);
+
+/**
+ * @brief Вставка таймера в пул, выросший сегментами по 4096 узлов, для сравнения с BM_Insert
+ *
+ */
+static void BM_InsertSegmented(benchmark::State &state) { insert<AsyncTimer>(state, 4'096); }
+BENCHMARK(BM_InsertSegmented)->Apply(queueArgs);
+
+/**
+ * @brief Моделирование часа работы: size таймеров на случайное время в течение часа выполняются
+ * через AsyncTimer::advanceClock в виртуальном времени (ClockSource::Manual), без ожидания
+ *
+ */
+static void BM_SimulatedHour(benchmark::State &state)
+{
+    const uint32_t size = static_cast<uint32_t>(state.range(0));
+    const uint64_t hour_ns = 3'600'000'000'000;
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<uint64_t> distrib(1, hour_ns);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        ManualClock::set(1'000'000'000);
+        auto at = std::make_unique<AsyncTimer>(size, 1, backendArg(state), TimingWheel::Params{}, ClockSource::Manual);
+        for (uint32_t i = 0; i < size; ++i)
+            at->createNanoTimer(distrib(gen), {});
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(at->advanceClock(hour_ns));
+        state.PauseTiming();
+        at.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_SimulatedHour)->Apply(queueArgs)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Создание таймера на max_timers = 1'000'000: пул целиком (segment = 0) или первым сегментом
+ *
+ */
+static void BM_Construct(benchmark::State &state)
+{
+    const uint32_t segment = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state)
+    {
+        AsyncTimer at(1'000'000, 1, TimerBackend::Heap, {}, ClockSource::Steady, segment);
+        benchmark::DoNotOptimize(at.capacity());
+    }
+}
+BENCHMARK(BM_Construct)->Arg(0)->Arg(4'096)->ArgName("segment")->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Удаление таймера из очереди размера size
+ *
+ */
+static void BM_Delete(benchmark::State &state)
+{
+    const uint32_t size = static_cast<uint32_t>(state.range(0));
+    std::mt19937_64 gen(1);
+    AsyncTimer at(size, 1, backendArg(state));
+    std::vector<uint64_t> ids = fill(at, size, gen);
+    std::shuffle(ids.begin(), ids.end(), gen);
+    size_t pos = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(at.deleteTimer(ids[pos++]));
+        if (pos == std::min<size_t>(REFILL, ids.size()))
+        {
+            state.PauseTiming();
+            auto added = fill(at, static_cast<uint32_t>(pos), gen);
+            std::copy(added.begin(), added.end(), ids.begin());
+            std::shuffle(ids.begin(), ids.end(), gen);
+            pos = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Delete)->Apply(queueArgs);
+
+/**
+ * @brief Продление таймаута: перенос случайного таймера из очереди размера size на более позднее время
+ *
+ */
+static void BM_Reschedule(benchmark::State &state)
+{
+    const uint32_t size = static_cast<uint32_t>(state.range(0));
+    std::mt19937_64 gen(1);
+    AsyncTimer at(size, 1, backendArg(state));
+    std::vector<uint64_t> ids = fill(at, size, gen);
+    std::shuffle(ids.begin(), ids.end(), gen);
+    uint64_t delay_ns = 2 * FAR_NS;
+    size_t pos = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(at.rescheduleTimer(ids[pos], delay_ns++));
+        if (++pos == ids.size())
+            pos = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Reschedule)->Apply(queueArgs);
+
+/**
+ * @brief Продление таймаута удалением и созданием таймера, для сравнения с BM_Reschedule
+ *
+ */
+static void BM_DeleteCreate(benchmark::State &state)
+{
+    const uint32_t size = static_cast<uint32_t>(state.range(0));
+    std::mt19937_64 gen(1);
+    AsyncTimer at(size, 1, backendArg(state));
+    std::vector<uint64_t> ids = fill(at, size, gen);
+    std::shuffle(ids.begin(), ids.end(), gen);
+    uint64_t delay_ns = 2 * FAR_NS;
+    size_t pos = 0;
+    for (auto _ : state)
+    {
+        at.deleteTimer(ids[pos]);
+        ids[pos] = at.createNanoTimer(delay_ns++, {}).id;
+        if (++pos == ids.size())
+            pos = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeleteCreate)->Apply(queueArgs);
+
+/**
+ * @brief Закрытие сессии: удаление ее 4 таймеров одним cancelGroup и создание новой сессии, size таймеров в очереди
+ *
+ */
+static void BM_CancelGroup(benchmark::State &state)
+{
+    const uint32_t size = static_cast<uint32_t>(state.range(0));
+    const uint64_t sessions = size / 4;
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<uint64_t> distrib(FAR_NS, 2 * FAR_NS);
+    AsyncTimer at(size, 1, backendArg(state));
+    for (uint64_t s = 0; s < sessions; ++s)
+        for (int t = 0; t < 4; ++t)
+            at.createGroupTimer(s + 1, distrib(gen), {});
+    uint64_t session = 0;
+    for (auto _ : state)
+    {
+        uint64_t group = session % sessions + 1;
+        at.cancelGroup(group);
+        for (int t = 0; t < 4; ++t)
+            at.createGroupTimer(group, distrib(gen), {});
+        session += 7919; // Сессии закрываются не по порядку создания
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CancelGroup)->Apply(queueArgs);
+
+/**
+ * @brief Закрытие сессии удалением 4 таймеров по id, для сравнения с BM_CancelGroup
+ *
+ */
+static void BM_DeleteSession(benchmark::State &state)
+{
+    const uint32_t size = static_cast<uint32_t>(state.range(0));
+    const uint64_t sessions = size / 4;
+    std::mt19937_64 gen(1);
+    AsyncTimer at(size, 1, backendArg(state));
+    std::vector<uint64_t> ids = fill(at, static_cast<uint32_t>(sessions * 4), gen);
+    std::uniform_int_distribution<uint64_t> distrib(FAR_NS, 2 * FAR_NS);
+    uint64_t session = 0;
+    for (auto _ : state)
+    {
+        uint64_t *group = ids.data() + 4 * (session % sessions);
+        at.deleteTimers(group, 4);
+        for (int t = 0; t < 4; ++t)
+            group[t] = at.createNanoTimer(distrib(gen), {}).id;
+        session += 7919;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeleteSession)->Apply(queueArgs);
+
+/**
+ * @brief Сработка size истекших таймеров за один проход
+ *
+ */
+static void BM_Expire(benchmark::State &state)
+{
+    const uint32_t size = static_cast<uint32_t>(state.range(0));
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<uint64_t> distrib(0, 1'000'000);
+    AsyncTimer at(size, 1, backendArg(state));
+    uint64_t fired = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (uint32_t i = 0; i < size; ++i)
+            at.createNanoTimer(distrib(gen), [&fired]()
+                               { fired++; });
+        std::this_thread::sleep_for(2ms);
+        state.ResumeTiming();
+        at.checkTimersNow();
+    }
+    state.SetItemsProcessed(fired);
+}
+BENCHMARK(BM_Expire)->Apply(queueArgs)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Создание и сработка таймера в потоке-владельце: AsyncTimer без цикла проверки (checkTimersNow)
+ *
+ */
+static void BM_CreateFire(benchmark::State &state)
+{
+    AsyncTimer at(1'024, 1);
+    uint64_t fired = 0;
+    for (auto _ : state)
+    {
+        at.createNanoTimer(0, [&fired]()
+                           { fired++; });
+        at.checkTimersNow();
+    }
+    state.SetItemsProcessed(fired);
+}
+BENCHMARK(BM_CreateFire);
+
+/**
+ * @brief Создание и сработка таймера в потоке-владельце: LocalTimer (poll), для сравнения с BM_CreateFire
+ *
+ */
+static void BM_LocalCreateFire(benchmark::State &state)
+{
+    LocalTimer lt(1'024);
+    uint64_t fired = 0;
+    for (auto _ : state)
+    {
+        lt.createNanoTimer(0, [&fired]()
+                           { fired++; });
+        lt.poll();
+    }
+    state.SetItemsProcessed(fired);
+}
+BENCHMARK(BM_LocalCreateFire);
+
+/**
+ * @brief Создание таймеров из нескольких потоков при работающем цикле проверки
+ *
+ */
+static void BM_MultiProducer(benchmark::State &state)
+{
+    static std::unique_ptr<AsyncTimer> at;
+    static std::unique_ptr<running::AutoThread> thr;
+    if (state.thread_index() == 0)
+    {
+        at = std::make_unique<AsyncTimer>(1'000'000, 1'000'000);
+        thr = std::make_unique<running::AutoThread>(at.get());
+        std::this_thread::sleep_for(10ms);
+    }
+    uint64_t i = 0;
+    uint64_t rejected = 0;
+    for (auto _ : state)
+    {
+        // Короткие таймеры, чтобы очередь не переполнялась
+        if (!at->createNanoTimer(10'000 + (i++ & 0xFFFF), {}).id)
+            rejected++;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["rejected"] = benchmark::Counter(static_cast<double>(rejected), benchmark::Counter::kAvgThreads);
+    if (state.thread_index() == 0)
+    {
+        thr.reset();
+        at.reset();
+    }
+}
+BENCHMARK(BM_MultiProducer)->ThreadRange(1, 16)->UseRealTime();
+
+/**
+ * @brief Создание таймеров из нескольких потоков в шарде текущего ядра ShardedAsyncTimer
+ *
+ */
+static void BM_ShardedMultiProducer(benchmark::State &state)
+{
+    static std::unique_ptr<ShardedAsyncTimer> at;
+    if (state.thread_index() == 0)
+    {
+        ShardedAsyncTimer::Params params;
+        params.shards = static_cast<uint32_t>(state.range(0));
+        params.max_timers = 1'000'000;
+        at = std::make_unique<ShardedAsyncTimer>(params);
+    }
+    uint64_t i = 0;
+    uint64_t rejected = 0;
+    for (auto _ : state)
+    {
+        // Короткие таймеры, чтобы очередь не переполнялась
+        if (!at->createNanoTimer(10'000 + (i++ & 0xFFFF), {}).id)
+            rejected++;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["rejected"] = benchmark::Counter(static_cast<double>(rejected), benchmark::Counter::kAvgThreads);
+    if (state.thread_index() == 0)
+        at.reset();
+}
+BENCHMARK(BM_ShardedMultiProducer)->ArgName("shards")->Arg(1)->Arg(4)->ThreadRange(1, 16)->UseRealTime();
+
+/**
+ * @brief Задержка сработки под нагрузкой: rate таймеров в секунду с задержкой до 10 мс
+ *
+ */
+static void BM_LatenessUnderLoad(benchmark::State &state)
+{
+    const uint64_t rate = static_cast<uint64_t>(state.range(0));
+    const uint64_t duration_ns = 200'000'000;
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<uint64_t> distrib(1'000, 10'000'000);
+    AsyncTimer::Stats stats;
+    for (auto _ : state)
+    {
+        AsyncTimer at(static_cast<uint32_t>(rate / 10 + 1'000), 1'000'000);
+        {
+            running::AutoThread thr(&at);
+            std::this_thread::sleep_for(10ms);
+            uint64_t start = getTimeNs();
+            uint64_t created = 0;
+            for (uint64_t now = start; now - start < duration_ns; now = getTimeNs())
+            {
+                // Равномерная подача таймеров с заданной частотой
+                for (uint64_t due = (now - start) * rate / 1'000'000'000; created < due; ++created)
+                    at.createNanoTimer(distrib(gen), {});
+                std::this_thread::yield();
+            }
+            std::this_thread::sleep_for(20ms);
+        }
+        stats = at.stats();
+    }
+    state.counters["p50_ns"] = static_cast<double>(stats.lateness.p50);
+    state.counters["p99_ns"] = static_cast<double>(stats.lateness.p99);
+    state.counters["p999_ns"] = static_cast<double>(stats.lateness.p999);
+    state.counters["max_ns"] = static_cast<double>(stats.lateness.max);
+    state.counters["fired"] = static_cast<double>(stats.lateness.count);
+}
+BENCHMARK(BM_LatenessUnderLoad)->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Стоимость чтения времени для каждого ClockSource
+ *
+ */
+static void BM_Clock(benchmark::State &state)
+{
+    // Для Tsc калибровка выполняется при первом вызове, до замера
+    ClockFn clock = getClock(static_cast<ClockSource>(state.range(0)));
+    clock();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(clock());
+}
+BENCHMARK(BM_Clock)
+    ->ArgName("source")
+    ->Arg(static_cast<int64_t>(ClockSource::Steady))
+    ->Arg(static_cast<int64_t>(ClockSource::MonotonicCoarse))
+    ->Arg(static_cast<int64_t>(ClockSource::Tsc))
+    ->Arg(static_cast<int64_t>(ClockSource::System))
+    ->Arg(static_cast<int64_t>(ClockSource::Manual));
+
+BENCHMARK_MAIN();
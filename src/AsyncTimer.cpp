@@ -1,180 +1,83 @@
 #include "AsyncTimer.h"
-#include <thread>
-#include <chrono>
-using namespace std::chrono_literals;
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
 
-uint64_t getTimeNs()
+namespace timer_detail
 {
-    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-}
-
-AsyncTimer::AsyncTimer(uint32_t max_timers, uint64_t check_interval_ns)
-    : max_timers_(max_timers),
-      check_interval_ns_(check_interval_ns),
-      qsize_(0),
-      tasks_queue_(Comp(), Container(max_timers_)),
-      cur_ns_(0),
-      max_delay_(0),
-      max_size_(0),
-      running_(false),
-      timer_info_id_(0)
-{
-
-    while (!tasks_queue_.empty())
-        tasks_queue_.pop();
-}
-
-AsyncTimer::~AsyncTimer()
-{
-    while (!tasks_queue_.empty())
-    {
-        tasks_queue_.top().run();
-        tasks_queue_.pop();
-    }
-}
-
-TimerInfo AsyncTimer::addTimer_(uint64_t ns, AsyncTimerTask::Cb cb, bool is_async)
-{
-    uint64_t cur_ns = 0;
-    if (qsize_ == max_timers_)
-        return {};
-    if (cur_ns = getTimeNs(); cur_ns == 0)
-        return {};
-    ns += cur_ns;
-    cur_ns_ = cur_ns;
-    tasks_queue_.emplace(ns, cb, ++timer_info_id_, is_async);
-    qsize_++;
-    return {timer_info_id_, cur_ns, ns};
-}
-
-TimerInfo AsyncTimer::createNanoTimer(uint64_t ns, AsyncTimerTask::Cb cb, bool is_async)
-{
-    TimerInfo ret;
-    if (running_.load())
+    int openPollFds(int &timer_fd, int &event_fd)
     {
-        std::lock_guard lock(mtx_);
-        ret = addTimer_(ns, cb, is_async);
-        new_timer_event_.notify_one();
-    }
-    else
-    {
-        ret = addTimer_(ns, cb, is_async);
-    }
-    return ret;
-}
-
-TimerInfo AsyncTimer::createMilliTimer(uint64_t ms, AsyncTimerTask::Cb cb, bool is_async)
-{
-    uint64_t ns = ms * 1'000'000;
-    return createNanoTimer(ns, cb, is_async);
-}
-
-TimerInfo AsyncTimer::createSecTimer(uint32_t sec, AsyncTimerTask::Cb cb, bool is_async)
-{
-    uint64_t ns = static_cast<uint64_t>(sec) * 1'000'000'000;
-    return createNanoTimer(ns, cb, is_async);
-}
-
-bool AsyncTimer::delTimer_(uint64_t id, TaskQueue &nq)
-{
-    bool ret = false;
-    while (!tasks_queue_.empty())
-    {
-        const auto &el = tasks_queue_.top();
-        if (el.id != id)
-        {
-            nq.emplace(el);
-        }
-        else
+#ifdef __linux__
+        timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        int poll_fd = epoll_create1(EPOLL_CLOEXEC);
+        bool ok = timer_fd >= 0 && event_fd >= 0 && poll_fd >= 0;
+        for (int fd : {timer_fd, event_fd})
         {
-            ret = true;
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            ok = ok && epoll_ctl(poll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
         }
-        tasks_queue_.pop();
+        if (ok)
+            return poll_fd;
+        closeFd(poll_fd);
+        closeFd(timer_fd);
+        closeFd(event_fd);
+#endif
+        return -1;
     }
-    tasks_queue_.swap(nq);
-    return ret;
-}
 
-bool AsyncTimer::deleteTimer(uint64_t id)
-{
-    TaskQueue new_queue{Comp(), Container(max_timers_)};
-    while (!new_queue.empty())
-        new_queue.pop();
-
-    if (running_.load())
+    void closeFd(int &fd)
     {
-        std::lock_guard lock(mtx_);
-        return delTimer_(id, new_queue);
+#ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+#endif
+        fd = -1;
     }
-    return delTimer_(id, new_queue);
-}
 
-size_t AsyncTimer::checkTimers()
-{
-    uint64_t delay = 0;
-    size_t count = 0;
-    while (!tasks_queue_.empty() && tasks_queue_.top().ns <= cur_ns_)
+    void armTimerFd(int timer_fd, uint64_t ns)
     {
-        count++;
-        if (tasks_queue_.top().cb)
+#ifdef __linux__
+        if (timer_fd < 0)
+            return;
+        itimerspec its{};
+        if (ns != UINT64_MAX)
         {
-            if (!tasks_queue_.top().is_async)
-                tasks_queue_.top().cb();
-            else
-            {
-                std::thread t(tasks_queue_.top().cb);
-                t.detach();
-            }
+            its.it_value.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+            its.it_value.tv_nsec = static_cast<long>(ns % 1'000'000'000);
         }
-        cur_ns_ = getTimeNs();
-        delay = cur_ns_ - tasks_queue_.top().ns;
-        max_delay_ = std::max(max_delay_, delay);
-        max_size_ = std::max(max_size_, qsize_);
-        tasks_queue_.pop();
-        qsize_--;
+        timerfd_settime(timer_fd, 0, &its, nullptr);
+#else
+        (void)timer_fd;
+        (void)ns;
+#endif
     }
-    return count;
-}
 
-void AsyncTimer::checkTimersNow()
-{
-    if (running_.load())
+    void readFd(int fd)
     {
-        // std::lock_guard<std::mutex> lock(mtx_);
-        new_timer_event_.notify_one();
+#ifdef __linux__
+        uint64_t value = 0;
+        if (fd >= 0)
+            read(fd, &value, sizeof(value));
+#else
+        (void)fd;
+#endif
     }
-    else
-    {
-        uint64_t cur_ns = 0;
-        if (cur_ns = getTimeNs(); cur_ns != 0)
-        {
-            cur_ns_ = cur_ns;
-            checkTimers();
-        }
-    }
-}
 
-void AsyncTimer::run(std::atomic_bool &terminate)
-{
-    uint64_t cur_ns = 0;
-    uint64_t timeout = 0;
-    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
-    running_.store(true);
-    while (!terminate.load(std::memory_order_relaxed))
+    void signalFd(int event_fd)
     {
-        cur_ns = getTimeNs();
-        if (cur_ns != 0)
-        {
-            lock.lock();
-            cur_ns_ = cur_ns;
-            if (!tasks_queue_.empty())
-                timeout = std::min(check_interval_ns_, tasks_queue_.top().ns >= cur_ns_ ? tasks_queue_.top().ns - cur_ns_ : cur_ns_ - tasks_queue_.top().ns);
-            else
-                timeout = check_interval_ns_;
-            new_timer_event_.wait_for(lock, std::chrono::nanoseconds(timeout));
-            checkTimers();
-            lock.unlock();
-        }
+#ifdef __linux__
+        uint64_t one = 1;
+        write(event_fd, &one, sizeof(one));
+#else
+        (void)event_fd;
+#endif
     }
-    running_.store(false);
-}
+} // namespace timer_detail
+
+template class BasicAsyncTimer<DefaultTimerPolicy>;
@@ -1,59 +1,21 @@
 #pragma once
 #include <cstdint>
-#include <functional>
 #include <vector>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
 #include "Runnable.h"
+#include "MpmcQueue.h"
+#include "AsyncTimerTask.h"
+#include "TimerQueue.h"
+#include "TimingWheel.h"
+#include "WorkerPool.h"
+#include "Histogram.h"
+#include "TimerPolicy.h"
+#include "TimerGroups.h"
+#include <type_traits>
 
-/**
- * @brief Функция получения текущего времени в наносекундах
- *
- * @return uint64_t Кол-во наносекунд
- */
-uint64_t getTimeNs();
-/**
- * @brief Задание таймера
- *
- */
-struct alignas(64) AsyncTimerTask
-{
-    using Cb = std::function<void()>;
-    uint64_t ns = 0;       ///< Время сработки таймера в наносекундах
-    bool is_async = false; ///< Асинхронное выполнение задания
-    Cb cb;                 ///< Задание таймера
-    uint64_t id = 0;       ///< id таймера
-
-    AsyncTimerTask() = default;
-    AsyncTimerTask(const AsyncTimerTask &o) = default;
-    AsyncTimerTask(AsyncTimerTask &&o) = default;
-    AsyncTimerTask &operator=(const AsyncTimerTask &o)
-    {
-        if (&o != this)
-        {
-            ns = o.ns;
-            is_async = o.is_async;
-            cb = o.cb;
-            id = o.id;
-        }
-        return *this;
-    };
-    AsyncTimerTask(uint64_t ns, Cb cb, uint64_t id, bool is_async = false) : ns(ns), id(id), is_async(is_async), cb(cb){};
-    ~AsyncTimerTask() = default;
-    bool operator<(const AsyncTimerTask &o) const { return ns < o.ns; }
-    bool operator>(const AsyncTimerTask &o) const { return ns > o.ns; }
-    bool operator==(const AsyncTimerTask &o) const { return ns == o.ns; }
-    /**
-     * @brief Запуск задания таймера
-     *
-     */
-    void run() const
-    {
-        if (cb)
-            cb();
-    }
-};
+template <typename Policy>
+class BasicLocalTimer;
 
 struct TimerInfo
 {
@@ -63,43 +25,111 @@ struct TimerInfo
     TimerInfo() = default;
     TimerInfo(uint64_t id, uint64_t start_tm_ns, uint64_t shedule_tm_ns) : id(id), start_tm_ns(start_tm_ns), shedule_tm_ns(shedule_tm_ns) {}
 };
+/**
+ * @brief Параметры таймера для пакетного создания
+ *
+ */
+struct TimerRequest
+{
+    uint64_t ns = 0;        ///< Ожидание в наносекундах
+    AsyncTimerTask::Cb cb;  ///< Функция выполняющаяся по истечении таймера
+    bool is_async = false;  ///< Асинхронное выполнение задания
+    uint64_t slack_ns = DEFAULT_SLACK; ///< Допустимое опоздание для объединения сработок, 0 - точный таймер
+    uint64_t group = 0;     ///< Группа таймера, 0 - без группы
+
+    static constexpr uint64_t DEFAULT_SLACK = ~0ull; ///< Допуск таймера по умолчанию (AsyncTimer::setTimerSlack)
+};
+/**
+ * @brief Поведение при создании таймера, когда активны max_timers таймеров
+ *
+ */
+enum class OverflowPolicy : uint8_t
+{
+    Reject,     ///< Таймер не создается (id = 0)
+    Block,      ///< Ожидание освобождения места до таймаута (при работе цикла проверки), затем Reject
+    EvictLatest ///< Удаление таймера с самым поздним временем сработки, если он позже нового, иначе Reject; O(n)
+};
 /**
  * @brief Асинхронный таймер
  *
+ * @tparam Policy Параметры времени компиляции (см. DefaultTimerPolicy)
  */
-class AsyncTimer : public running::IRunnable
+template <typename Policy = DefaultTimerPolicy>
+class BasicAsyncTimer : public running::IRunnable
 {
-    using Container = std::vector<AsyncTimerTask>;
-    using Comp = std::greater<AsyncTimerTask>;
-    using TaskQueue = std::priority_queue<AsyncTimerTask, Container, Comp>;
+    using Clock = typename Policy::Clock;
+    using Queue = typename Policy::Queue;
+    using Size = std::conditional_t<Policy::concurrent, std::atomic<size_t>, size_t>;
+
+    static constexpr uint32_t SUBMIT_QUEUE_SIZE = 4096; ///< Емкость очереди передачи новых таймеров
+    static constexpr uint32_t EXPIRED_BATCH = 256;      ///< Максимум заданий, извлекаемых за один захват мьютекса
+    static constexpr uint64_t MAX_SLEEP_NS = 3'600'000'000'000; ///< Предел одного сна до дальнего таймера (переполнение chrono)
 
 private:
     const uint32_t max_timers_;
-    const uint64_t check_interval_ns_;
-    size_t qsize_;
-    TaskQueue tasks_queue_;
+    const Clock now_;
+    Size qsize_;
+    TimerSlab slab_;                         ///< Задания таймеров, id таймера - дескриптор узла пула
+    std::unique_ptr<Queue> tasks_queue_;
+    MpmcQueue<uint32_t> submit_queue_;       ///< Узлы таймеров, созданных во время работы цикла проверки
+    std::atomic<uint64_t> wake_ns_;          ///< Время пробуждения цикла проверки, 0 - цикл не спит
+    std::atomic<uint64_t> wake_seq_;         ///< Счетчик вызовов wakeDispatcher, прерывает активное ожидание
+    uint64_t spin_ns_;                       ///< Окно активного ожидания перед сработкой, 0 - выключено
+    std::atomic<uint64_t> slack_ns_;         ///< Допуск таймеров по умолчанию, 0 - точные таймеры
+    int poll_fd_;                            ///< epoll с timer_fd_ и event_fd_ для внешнего цикла, -1 - нет
+    int timer_fd_;                           ///< timerfd, взведенный на ближайшую сработку
+    int event_fd_;                           ///< eventfd для таймеров раньше взведенного
+    std::vector<uint32_t> expired_;          ///< Узлы извлеченных заданий, выполняются без захвата мьютекса
+    std::vector<uint32_t> batch_;            ///< Буфер пакетного создания таймеров
+    std::vector<uint32_t> cancelled_;        ///< Периодические таймеры из expired_, удаленные во время выполнения
+    std::vector<std::pair<uint64_t, bool>> deadlines_; ///< Время и признак округления заданий expired_ для wakeups_saved_
     uint64_t cur_ns_;
-    std::mutex mtx_;
+    mutable std::mutex mtx_;
     std::condition_variable new_timer_event_;
-    uint64_t max_delay_;
-    size_t max_size_;
+    std::condition_variable space_event_;   ///< Освобождение места для OverflowPolicy::Block
+    std::atomic<uint32_t> space_waiters_;   ///< Потоки, ожидающие места
+    std::atomic<OverflowPolicy> overflow_policy_; ///< Читается без мьютекса, когда цикл проверки не работает
+    std::atomic<uint64_t> block_timeout_ns_;      ///< Предел ожидания места для OverflowPolicy::Block
+    Histogram lateness_;    ///< Задержка начала выполнения задания относительно расчетного времени
+    Histogram run_time_;    ///< Время выполнения синхронного задания
+    Histogram queue_depth_; ///< Количество активных таймеров при создании таймера
+    std::atomic<uint64_t> wakeups_saved_; ///< Таймеры, которые допуск сдвинул на время сработки другого таймера
+    std::atomic<uint64_t> wakeups_;          ///< Пробуждения цикла проверки
+    std::atomic<uint64_t> spurious_wakeups_; ///< Пробуждения, после которых нечего выполнять
+    std::atomic<uint64_t> rejected_;         ///< Таймеры, отклоненные или вытесненные из заполненной очереди
     std::atomic_bool running_;
-    uint64_t timer_info_id_;
+    std::unique_ptr<TimerGroups> groups_; ///< Списки таймеров по группам, создаются при первом таймере с группой
+    WorkerPool::Params worker_params_;
+    std::unique_ptr<WorkerPool> workers_;
 
 public:
     /**
      * @brief Конструктор с параметрами
      *
      * @param max_timers Максимальное количество таймеров
-     * @param check_interval_ns Интервал проверки таймеров(наносек.)
+     * @param check_interval_ns Не используется: цикл проверки спит до ближайшего таймера или создания более раннего
+     * @deprecated check_interval_ns оставлен для совместимости и будет удален, передавайте любое значение
+     */
+    BasicAsyncTimer(uint32_t max_timers, uint64_t check_interval_ns);
+    /**
+     * @brief Конструктор с выбором очереди заданий
+     *
+     * @param max_timers Максимальное количество таймеров (если не задано в Policy::max_timers)
+     * @param check_interval_ns Не используется (deprecated), см. выше
+     * @param backend Тип очереди заданий (если Policy::Queue - ITimerQueue)
+     * @param wheel_params Параметры колеса таймеров (для TimerBackend::Wheel)
+     * @param clock Источник времени, в нем же задаются времена в TimerInfo
+     * @param segment_size Рост пула заданий сегментами по segment_size узлов, 0 - пул на max_timers сразу
      */
-    AsyncTimer(uint32_t max_timers, uint64_t check_interval_ns);
-    AsyncTimer() = delete;
-    AsyncTimer(const AsyncTimer &) = delete;
-    AsyncTimer(AsyncTimer &&) = delete;
-    AsyncTimer &operator=(const AsyncTimer &) = delete;
-    AsyncTimer &operator=(AsyncTimer &&) = delete;
-    ~AsyncTimer();
+    BasicAsyncTimer(uint32_t max_timers, uint64_t check_interval_ns, TimerBackend backend,
+                    const TimingWheel::Params &wheel_params = {}, ClockSource clock = ClockSource::Steady,
+                    uint32_t segment_size = 0);
+    BasicAsyncTimer() = delete;
+    BasicAsyncTimer(const BasicAsyncTimer &) = delete;
+    BasicAsyncTimer(BasicAsyncTimer &&) = delete;
+    BasicAsyncTimer &operator=(const BasicAsyncTimer &) = delete;
+    BasicAsyncTimer &operator=(BasicAsyncTimer &&) = delete;
+    ~BasicAsyncTimer();
     /**
      * @brief Создание таймера ожидающего ns наносекунд
      *
@@ -107,8 +137,11 @@ public:
      * @param cb функция выполняющаяся по истечении таймера
      * @param is_async асинхронное выполнение задания
      * @return uint64_t идентификатор таймера или 0 в случае ошибки
+     *
+     * Во время работы цикла проверки не захватывает мьютекс: задание передается через lock-free
+     * очередь, цикл проверки будится только если новый таймер истекает раньше его пробуждения.
      */
-    TimerInfo createNanoTimer(uint64_t ns, AsyncTimerTask::Cb cb, bool is_async = false);
+    TimerInfo createNanoTimer(uint64_t ns, AsyncTimerTask::Cb &&cb, bool is_async = false);
     /**
      * @brief Создание таймера ожидающего ms милисекунд
      *
@@ -117,7 +150,7 @@ public:
      * @param is_async асинхронное выполнение задания
      * @return uint64_t идентификатор таймера или 0 в случае ошибки
      */
-    TimerInfo createMilliTimer(uint64_t ms, AsyncTimerTask::Cb cb, bool is_async = false);
+    TimerInfo createMilliTimer(uint64_t ms, AsyncTimerTask::Cb &&cb, bool is_async = false);
     /**
      * @brief Создание таймера ожидающего sec секунд
      *
@@ -126,7 +159,42 @@ public:
      * @param is_async асинхронное выполнение задания
      * @return uint64_t идентификатор таймера или 0 в случае ошибки
      */
-    TimerInfo createSecTimer(uint32_t sec, AsyncTimerTask::Cb cb, bool is_async = false);
+    TimerInfo createSecTimer(uint32_t sec, AsyncTimerTask::Cb &&cb, bool is_async = false);
+    /**
+     * @brief Создание таймера ожидающего ns наносекунд в группе group
+     *
+     * @param group ключ группы (например id соединения), 0 - без группы
+     * @return TimerInfo информация о таймере, id = 0 в случае ошибки
+     *
+     * Все таймеры группы удаляются одним вызовом cancelGroup.
+     */
+    TimerInfo createGroupTimer(uint64_t group, uint64_t ns, AsyncTimerTask::Cb &&cb, bool is_async = false);
+    /**
+     * @brief Создание периодического таймера
+     *
+     * @param period_ns период в наносекундах, первое срабатывание через period_ns
+     * @param cb функция выполняющаяся каждый период (синхронно, в потоке таймера)
+     * @param policy режим перезапуска
+     * @param group ключ группы для cancelGroup, 0 - без группы
+     * @return TimerInfo информация о таймере, id = 0 в случае ошибки
+     *
+     * После выполнения задание перезапускается с тем же id и функцией без выделения памяти.
+     * Удаление таймера во время выполнения его задания отменяет следующие периоды.
+     */
+    TimerInfo createPeriodicTimer(uint64_t period_ns, AsyncTimerTask::Cb &&cb,
+                                  PeriodicPolicy policy = PeriodicPolicy::FixedRate, uint64_t group = 0);
+    /**
+     * @brief Пакетное создание таймеров
+     *
+     * @param timers Массив параметров таймеров, функции созданных таймеров перемещаются
+     * @param count Количество таймеров
+     * @param infos Массив из count элементов для информации о таймерах (в порядке timers),
+     * для несозданных таймеров id = 0
+     * @return size_t Количество созданных таймеров (первые из timers)
+     *
+     * Одно чтение часов, один захват мьютекса и не более одного пробуждения цикла проверки на пакет
+     */
+    size_t createTimers(TimerRequest *timers, size_t count, TimerInfo *infos);
     /**
      * @brief Удаление таймера
      *
@@ -134,37 +202,250 @@ public:
      * @return true Успешное удаление
      * @return false Таймер не найден
      *
-     * Тяжелая операция 2*log(n)
+     * Задание истекшего таймера извлекается из очереди до выполнения, после этого таймер удалить
+     * нельзя: возвращается false, задание будет выполнено.
+     * Для TimerBackend::Heap O(log n), для TimerBackend::Wheel O(1)
      */
     bool deleteTimer(uint64_t id);
+    /**
+     * @brief Пакетное удаление таймеров
+     *
+     * @param ids Массив id таймеров
+     * @param count Количество таймеров
+     * @return size_t Количество удаленных таймеров
+     *
+     * Один захват мьютекса на пакет
+     */
+    size_t deleteTimers(const uint64_t *ids, size_t count);
+    /**
+     * @brief Удаление всех таймеров группы
+     *
+     * @param group ключ группы
+     * @return size_t Количество удаленных таймеров
+     *
+     * O(размер группы) по интрузивному списку группы, без обхода очереди. Как и в deleteTimer,
+     * выполняющееся однократное задание не отменяется, у периодического отменяются следующие периоды.
+     */
+    size_t cancelGroup(uint64_t group);
+    /**
+     * @brief Перенос сработки таймера на new_delay_ns наносекунд от текущего времени
+     *
+     * @param id id таймера
+     * @param new_delay_ns новое ожидание в наносекундах
+     * @return TimerInfo информация о таймере с тем же id, id = 0 если таймер не найден
+     *
+     * Сохраняет id и функцию таймера. Для TimerBackend::Heap перенос на более позднее время O(1),
+     * на более раннее O(log n), для TimerBackend::Wheel O(1). Задание истекшего таймера не переносится.
+     * Новое время округляется допуском, с которым таймер был создан.
+     */
+    TimerInfo rescheduleTimer(uint64_t id, uint64_t new_delay_ns);
     /**
      * @brief Запуск цикла проверки таймеров
      *
      * @param terminate Флаг для остановки цикла проверки
+     * Цикл спит до ближайшего таймера, при пустой очереди - до создания таймера. После установки terminate
+     * вызывается wake() (так делает running::AutoThread), иначе цикл не увидит флаг до следующего пробуждения.
      */
     void run(std::atomic_bool &terminate) override;
+    /**
+     * @brief Работает ли цикл проверки (run() или openPollFd())
+     *
+     * @return true Таймер потокобезопасен: создание и удаление синхронизированы с циклом проверки
+     * До запуска цикла вызовы из нескольких потоков не синхронизированы, поэтому владелец потока с run()
+     * дожидается isRunning() перед передачей таймера производителям.
+     */
+    bool isRunning() const { return running(); }
+    /**
+     * @brief Текущее время источника таймера в наносекундах
+     *
+     */
+    uint64_t now() const { return now_(); }
+    /**
+     * @brief Пробуждение цикла проверки для остановки (running::AutoThread)
+     *
+     */
+    void wake() override;
     /**
      * @brief Проверить таймеры сейчас (не дожидаясь истечения интервала таймера)
      *
      */
     void checkTimersNow();
     /**
-     * @brief Получение максимальной задержки в наносекундах
+     * @brief Время, не позднее которого нужно проверить таймеры
+     *
+     * @return uint64_t Время источника таймера, UINT64_MAX если таймеров нет
+     */
+    uint64_t nextDeadline();
+    /**
+     * @brief Моделирование: сдвиг ManualClock на ns наносекунд с выполнением истекающих таймеров
+     *
+     * @param ns сдвиг виртуального времени в наносекундах
+     * @return size_t Количество выполненных заданий
+     *
+     * Только для ClockSource::Manual или Policy::Clock = ManualClock: для другого источника времени
+     * ManualClock не изменяется и возвращается 0. Время общее для всех таймеров с ManualClock, поэтому
+     * сдвиг видят и они; их задания выполняются при их собственной проверке. Без цикла проверки время переводится на
+     * каждую сработку по порядку, задания (в том числе созданные заданиями и периоды) выполняются в вызывающем
+     * потоке точно в свое время без ожидания. При работающем цикле проверки только сдвигает время и будит
+     * цикл, возвращает 0.
+     */
+    size_t advanceClock(uint64_t ns);
+    /**
+     * @brief Гистограммы таймера
+     *
+     */
+    struct Stats
+    {
+        Histogram::Snapshot lateness;    ///< Задержка начала выполнения задания, наносекунды
+        Histogram::Snapshot run_time;    ///< Время выполнения синхронного задания, наносекунды
+        Histogram::Snapshot queue_depth; ///< Количество активных таймеров при создании таймера
+        uint64_t wakeups_saved = 0;      ///< Таймеры, которые допуск сдвинул на общее с другими время сработки
+        uint64_t wakeups = 0;            ///< Пробуждения цикла проверки
+        uint64_t spurious_wakeups = 0;   ///< Пробуждения без сработавших таймеров и без нового ближайшего таймера
+        uint64_t rejected = 0;           ///< Таймеры, не созданные или вытесненные из-за заполненной очереди
+    };
+    /**
+     * @brief Получение снимка гистограмм
+     *
+     * @param reset Обнулить гистограммы
+     * @return Stats
+     * Потокобезопасен
+     */
+    Stats stats(bool reset = false);
+    /**
+     * @brief Получение максимальной задержки начала выполнения задания в наносекундах
      *
      * @return uint64_t
-     * Не потокобезопасен
      */
-    uint64_t maxDelay() const { return max_delay_; }
+    uint64_t maxDelay() const { return lateness_.max(); }
     /**
      * @brief Получение максимального количества активных таймеров
      *
      * @return uint64_t
-     * Не потокобезопасен
      */
-    uint64_t maxSize() const { return max_size_; }
+    uint64_t maxSize() const { return queue_depth_.max(); }
+    /**
+     * @brief Настройка пула потоков для асинхронных заданий
+     *
+     * @param params Параметры пула
+     * Пул создается сразу, без захвата мьютекса таймера. Без вызова пул с параметрами по умолчанию создается
+     * при запуске цикла проверки (run(), openPollFd()), а без цикла проверки - при первом асинхронном задании.
+     * @return false Цикл проверки уже запущен: его поток передает задания в пул без мьютекса, пул не заменяется
+     */
+    bool setWorkerPool(const WorkerPool::Params &params);
+    /**
+     * @brief Режим высокой точности
+     *
+     * @param spin_ns Окно активного ожидания в наносекундах, 0 - выключен
+     * Цикл проверки спит до момента за spin_ns до ближайшей сработки, затем опрашивает часы и очередь
+     * новых таймеров без сна. Занимает ядро на время окна, рекомендуется привязка потока таймера к
+     * выделенному ядру (running::AutoThread с core_id). Вызывать до запуска цикла проверки таймеров.
+     */
+    void setPrecisionMode(uint64_t spin_ns);
+    /**
+     * @brief Допуск таймеров по умолчанию
+     *
+     * @param slack_ns Допустимое опоздание в наносекундах, 0 - точные таймеры
+     * Время сработки округляется вверх до кратного наибольшей степени двойки, не превышающей slack_ns.
+     * Близкие таймеры получают общее время сработки и выполняются за одно пробуждение цикла проверки.
+     * Действует на createNanoTimer/createMilliTimer/createSecTimer и TimerRequest с DEFAULT_SLACK,
+     * периодические таймеры всегда точные. Потокобезопасен, действует на таймеры, создаваемые после вызова.
+     */
+    void setTimerSlack(uint64_t slack_ns);
+    /**
+     * @brief Поведение при заполненной очереди
+     *
+     * @param policy Режим, по умолчанию OverflowPolicy::Reject
+     * @param block_timeout_ns Предел ожидания места для OverflowPolicy::Block
+     * Каждый отклоненный или вытесненный таймер учитывается в Stats::rejected. Block ждет только при работе
+     * цикла проверки (иначе место некому освободить); ожидание в задании таймера задерживает цикл проверки.
+     * Пакетное создание (createTimers) всегда отклоняет таймеры сверх max_timers. Потокобезопасен.
+     */
+    void setOverflowPolicy(OverflowPolicy policy, uint64_t block_timeout_ns = 0);
+    /**
+     * @brief Количество узлов пула заданий, выделенных сейчас
+     *
+     * @return uint32_t max_timers без segment_size, иначе растет сегментами до max_timers
+     */
+    uint32_t capacity() const { return slab_.size(); }
+    /**
+     * @brief Освобождение сегментов пула в конце, в которых нет активных таймеров
+     *
+     * @return uint32_t Количество освобожденных узлов
+     * Первый сегмент сохраняется. Обходит все свободные узлы, предназначен для вызова в простое.
+     */
+    uint32_t shrinkCapacity();
+    /**
+     * @brief Включение режима работы от внешнего цикла событий (Linux)
+     *
+     * @return int Дескриптор для epoll/poll (EPOLLIN) или -1 в случае ошибки
+     * Дескриптор готов к чтению, когда наступило время ближайшего таймера или создан таймер раньше
+     * него. Владелец цикла вызывает processExpired(), задания выполняются в его потоке. Поток с run()
+     * в этом режиме не нужен и не должен запускаться. Дескриптор закрывается в деструкторе.
+     */
+    int openPollFd();
+    /**
+     * @brief Выполнение истекших таймеров без ожидания
+     *
+     * @return size_t Количество сработавших таймеров
+     * В режиме openPollFd() также сбрасывает готовность дескриптора и взводит его на следующую сработку
+     */
+    size_t processExpired();
+    /**
+     * @brief Получение счетчиков пула потоков асинхронных заданий
+     *
+     * @return WorkerPool::Stats
+     */
+    WorkerPool::Stats workerPoolStats() const;
 
 private:
-    size_t checkTimers();
-    bool delTimer_(uint64_t id, TaskQueue &q);
-    TimerInfo addTimer_(uint64_t ns, AsyncTimerTask::Cb cb, bool is_async);
-};
\ No newline at end of file
+    template <typename>
+    friend class BasicLocalTimer;
+
+    uint32_t maxTimers() const
+    {
+        if constexpr (Policy::max_timers != 0)
+            return Policy::max_timers;
+        else
+            return max_timers_;
+    }
+    bool running() const
+    {
+        if constexpr (Policy::concurrent)
+            return running_.load();
+        else
+            return false;
+    }
+    static void record(Histogram &h, uint64_t v, uint64_t count = 1)
+    {
+        if constexpr (Policy::stats)
+            h.record(v, count);
+    }
+    size_t checkTimers(std::unique_lock<std::mutex> &lock);
+    size_t checkTimersAt(uint64_t cur_ns);
+    void adoptSlot(uint32_t slot);
+    size_t takeExpired(uint64_t pass_ns);
+    uint64_t savedWakeups();
+    void runExpired();
+    void rearmExpired();
+    bool cancelExpired(uint32_t slot);
+    void releaseSlot(uint32_t slot);
+    void linkGroup(uint32_t slot);
+    void drainSubmitted();
+    void wakeDispatcher();
+    void closePollFd();
+    void startWorkers();
+    void armPollTimer(uint64_t next_ns);
+    uint64_t spinUntil(uint64_t deadline_ns, uint64_t wake_seq, const std::atomic_bool &terminate) const;
+    TimerInfo createTimer_(AsyncTimerTask &&task, uint64_t slack_ns = 0);
+    TimerInfo addTimer_(AsyncTimerTask &&task, uint64_t slack_ns);
+    TimerInfo overflow_(AsyncTimerTask &&task, uint64_t slack_ns);
+};
+
+#include "AsyncTimerImpl.h"
+
+using AsyncTimer = BasicAsyncTimer<DefaultTimerPolicy>;
+extern template class BasicAsyncTimer<DefaultTimerPolicy>;
+
+// Ожидание в сопрограммах - свободные функции, поэтому класс таймера одинаков в C++17 и C++20
+#include "TimerAwait.h"
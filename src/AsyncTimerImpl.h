@@ -0,0 +1,901 @@
+#pragma once
+// Реализация BasicAsyncTimer, подключается из AsyncTimer.h
+#include "HeapTimerQueue.h"
+#include "Bits.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <type_traits>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace timer_detail
+{
+    inline void cpuRelax()
+    {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#endif
+    }
+
+    /**
+     * @brief Округление времени сработки вверх до сетки, общей для таймеров с близким допуском
+     *
+     */
+    inline uint64_t applySlack(uint64_t ns, uint64_t slack_ns)
+    {
+        if (slack_ns < 2)
+            return ns;
+        uint64_t mask = (1ull << msb64(slack_ns)) - 1;
+        return ns > std::numeric_limits<uint64_t>::max() - mask ? ns : (ns + mask) & ~mask;
+    }
+    /**
+     * @brief Допуск, сохраняемый в задании: log2 сетки applySlack, 0 - точный таймер
+     *
+     */
+    inline uint8_t slackLog2(uint64_t slack_ns) { return slack_ns < 2 ? 0 : static_cast<uint8_t>(msb64(slack_ns)); }
+
+    /**
+     * @brief Таймер читает виртуальное время ManualClock
+     *
+     */
+    template <typename Clock>
+    bool isManualClock(const Clock &) { return std::is_same_v<Clock, ManualClock>; }
+    inline bool isManualClock(const DynamicClock &clock) { return clock.manual(); }
+
+    /// Дескрипторы внешнего цикла событий (Linux, AsyncTimer.cpp), -1 в случае ошибки
+    int openPollFds(int &timer_fd, int &event_fd);
+    void closeFd(int &fd);
+    /// Взвод timerfd на ns наносекунд, UINT64_MAX - выключение
+    void armTimerFd(int timer_fd, uint64_t ns);
+    void readFd(int fd);
+    void signalFd(int event_fd);
+} // namespace timer_detail
+
+template <typename Policy>
+BasicAsyncTimer<Policy>::BasicAsyncTimer(uint32_t max_timers, uint64_t check_interval_ns)
+    : BasicAsyncTimer(max_timers, check_interval_ns, TimerBackend::Heap)
+{
+}
+
+template <typename Policy>
+BasicAsyncTimer<Policy>::BasicAsyncTimer(uint32_t max_timers, uint64_t /*check_interval_ns*/, TimerBackend backend,
+                       const TimingWheel::Params &wheel_params, ClockSource clock, uint32_t segment_size)
+    : max_timers_(max_timers),
+      now_(clock),
+      qsize_(0),
+      slab_(maxTimers(), segment_size),
+      submit_queue_(Policy::concurrent ? std::min(maxTimers(), SUBMIT_QUEUE_SIZE) : 1),
+      wake_ns_(0),
+      wake_seq_(0),
+      spin_ns_(0),
+      slack_ns_(0),
+      poll_fd_(-1),
+      timer_fd_(-1),
+      event_fd_(-1),
+      cur_ns_(0),
+      space_waiters_(0),
+      overflow_policy_(OverflowPolicy::Reject),
+      block_timeout_ns_(0),
+      wakeups_saved_(0),
+      wakeups_(0),
+      spurious_wakeups_(0),
+      rejected_(0),
+      running_(false)
+{
+    if constexpr (std::is_same_v<Queue, ITimerQueue>)
+    {
+        if (backend == TimerBackend::Wheel)
+            tasks_queue_ = std::make_unique<TimingWheel>(slab_, wheel_params, now_());
+        else
+            tasks_queue_ = std::make_unique<HeapTimerQueue>(slab_);
+    }
+    else if constexpr (std::is_same_v<Queue, TimingWheel>)
+        tasks_queue_ = std::make_unique<TimingWheel>(slab_, wheel_params, now_());
+    else
+        tasks_queue_ = std::make_unique<Queue>(slab_);
+    expired_.reserve(std::min(maxTimers(), EXPIRED_BATCH));
+    cancelled_.reserve(std::min(maxTimers(), EXPIRED_BATCH));
+    deadlines_.reserve(std::min(maxTimers(), EXPIRED_BATCH));
+}
+
+template <typename Policy>
+BasicAsyncTimer<Policy>::~BasicAsyncTimer()
+{
+    closePollFd();
+    drainSubmitted();
+    uint32_t slot = 0;
+    while (tasks_queue_->popExpired(std::numeric_limits<uint64_t>::max(), slot))
+        slab_[slot].run();
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::drainSubmitted()
+{
+    uint32_t slot = 0;
+    while (submit_queue_.tryPop(slot))
+    {
+        tasks_queue_->push(slot);
+        linkGroup(slot);
+    }
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::releaseSlot(uint32_t slot)
+{
+    if (groups_)
+        groups_->remove(slot);
+    slab_[slot] = AsyncTimerTask();
+    slab_.free(slot);
+    qsize_--;
+    // Во время работы цикла проверки узлы освобождаются под мьютексом, под которым ждут производители
+    if (space_waiters_.load(std::memory_order_relaxed) != 0)
+        space_event_.notify_one();
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::linkGroup(uint32_t slot)
+{
+    // Таймер входит в список группы, пока его узел не освобожден (в том числе между периодами)
+    if (uint64_t group = slab_[slot].group; group != 0)
+    {
+        if (!groups_)
+            groups_ = std::make_unique<TimerGroups>(slab_.capacity());
+        groups_->add(group, slot);
+    }
+}
+
+template <typename Policy>
+TimerInfo BasicAsyncTimer<Policy>::addTimer_(AsyncTimerTask &&task, uint64_t slack_ns)
+{
+    // Резерв места: под мьютексом addTimer_ конкурирует с lock-free созданием таймеров.
+    // При ошибке задание не перемещается
+    size_t qsize = qsize_++;
+    uint64_t cur_ns = 0;
+    uint32_t slot = TimerSlab::NIL;
+    if (qsize >= maxTimers() || (cur_ns = now_()) == 0 || (slot = slab_.alloc()) == TimerSlab::NIL)
+    {
+        qsize_--;
+        return {};
+    }
+    drainSubmitted();
+    uint64_t due_ns = task.ns + cur_ns;
+    task.ns = timer_detail::applySlack(due_ns, slack_ns);
+    task.rounded = task.ns != due_ns;
+    task.slack_log2 = timer_detail::slackLog2(slack_ns);
+    task.id = slab_.handle(slot);
+    cur_ns_ = cur_ns;
+    TimerInfo ret(task.id, cur_ns, task.ns);
+    slab_[slot] = std::move(task);
+    tasks_queue_->push(slot);
+    linkGroup(slot);
+    record(queue_depth_, qsize + 1);
+    return ret;
+}
+
+template <typename Policy>
+TimerInfo BasicAsyncTimer<Policy>::overflow_(AsyncTimerTask &&task, uint64_t slack_ns)
+{
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    if (running())
+        lock.lock();
+    TimerInfo ret;
+    OverflowPolicy policy = overflow_policy_.load(std::memory_order_relaxed);
+    if (policy == OverflowPolicy::EvictLatest)
+    {
+        drainSubmitted();
+        // Вытесняется только таймер позже нового с учетом округления допуском, иначе отклоняется новый
+        uint32_t victim = tasks_queue_->latest();
+        if (victim != TimerSlab::NIL && slab_[victim].ns > timer_detail::applySlack(now_() + task.ns, slack_ns) &&
+            tasks_queue_->remove(victim))
+        {
+            releaseSlot(victim);
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            ret = addTimer_(std::move(task), slack_ns);
+        }
+    }
+    else if (policy == OverflowPolicy::Block && lock.owns_lock())
+    {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::nanoseconds(block_timeout_ns_.load(std::memory_order_relaxed));
+        space_waiters_++;
+        for (;;)
+        {
+            ret = addTimer_(std::move(task), slack_ns);
+            if (ret.id != 0 || qsize_ < maxTimers() || space_event_.wait_until(lock, deadline) == std::cv_status::timeout)
+                break;
+        }
+        space_waiters_--;
+    }
+    if (ret.id == 0)
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+    else if (lock.owns_lock() && ret.shedule_tm_ns < wake_ns_.load())
+        wakeDispatcher();
+    return ret;
+}
+
+template <typename Policy>
+TimerInfo BasicAsyncTimer<Policy>::createTimer_(AsyncTimerTask &&task, uint64_t slack_ns)
+{
+    if (!running())
+    {
+        // addTimer_ перемещает задание только при успехе
+        if (TimerInfo ret = addTimer_(std::move(task), slack_ns); ret.id != 0 || qsize_ < maxTimers())
+            return ret;
+        return overflow_(std::move(task), slack_ns);
+    }
+    // Резервируем место, чтобы очередь заданий не переполнилась при переносе из очереди передачи
+    size_t qsize = qsize_++;
+    if (qsize >= maxTimers())
+    {
+        qsize_--;
+        return overflow_(std::move(task), slack_ns);
+    }
+    record(queue_depth_, qsize + 1);
+    uint64_t cur_ns = 0;
+    if (cur_ns = now_(); cur_ns == 0)
+    {
+        qsize_--;
+        return {};
+    }
+    // Резерв места в qsize_ гарантирует свободный узел пула
+    uint32_t slot = slab_.alloc();
+    uint64_t due_ns = task.ns + cur_ns;
+    task.ns = timer_detail::applySlack(due_ns, slack_ns);
+    task.rounded = task.ns != due_ns;
+    task.slack_log2 = timer_detail::slackLog2(slack_ns);
+    task.id = slab_.handle(slot);
+    TimerInfo ret(task.id, cur_ns, task.ns);
+    slab_[slot] = std::move(task);
+    if (!submit_queue_.tryPush(std::move(slot)))
+    {
+        // Очередь передачи заполнена, добавляем под мьютексом
+        std::lock_guard lock(mtx_);
+        drainSubmitted();
+        tasks_queue_->push(slot);
+        linkGroup(slot);
+        wakeDispatcher();
+        return ret;
+    }
+    // Парный барьер в run(): либо цикл проверки увидит задание перед сном, либо мы увидим wake_ns_
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ret.shedule_tm_ns < wake_ns_.load(std::memory_order_relaxed))
+    {
+        std::lock_guard lock(mtx_);
+        wakeDispatcher();
+    }
+    return ret;
+}
+
+template <typename Policy>
+TimerInfo BasicAsyncTimer<Policy>::createNanoTimer(uint64_t ns, AsyncTimerTask::Cb &&cb, bool is_async)
+{
+    return createTimer_(AsyncTimerTask(ns, std::move(cb), 0, is_async), slack_ns_.load(std::memory_order_relaxed));
+}
+
+template <typename Policy>
+TimerInfo BasicAsyncTimer<Policy>::createGroupTimer(uint64_t group, uint64_t ns, AsyncTimerTask::Cb &&cb, bool is_async)
+{
+    AsyncTimerTask task(ns, std::move(cb), 0, is_async);
+    task.group = group;
+    return createTimer_(std::move(task), slack_ns_.load(std::memory_order_relaxed));
+}
+
+template <typename Policy>
+TimerInfo BasicAsyncTimer<Policy>::createMilliTimer(uint64_t ms, AsyncTimerTask::Cb &&cb, bool is_async)
+{
+    uint64_t ns = ms * 1'000'000;
+    return createNanoTimer(ns, std::move(cb), is_async);
+}
+
+template <typename Policy>
+TimerInfo BasicAsyncTimer<Policy>::createSecTimer(uint32_t sec, AsyncTimerTask::Cb &&cb, bool is_async)
+{
+    uint64_t ns = static_cast<uint64_t>(sec) * 1'000'000'000;
+    return createNanoTimer(ns, std::move(cb), is_async);
+}
+
+template <typename Policy>
+TimerInfo BasicAsyncTimer<Policy>::createPeriodicTimer(uint64_t period_ns, AsyncTimerTask::Cb &&cb, PeriodicPolicy policy,
+                                                       uint64_t group)
+{
+    if (period_ns == 0)
+        return {};
+    AsyncTimerTask task(period_ns, std::move(cb), 0);
+    task.period_ns = period_ns;
+    task.policy = policy;
+    task.group = group;
+    return createTimer_(std::move(task));
+}
+
+template <typename Policy>
+size_t BasicAsyncTimer<Policy>::createTimers(TimerRequest *timers, size_t count, TimerInfo *infos)
+{
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    if (running())
+        lock.lock();
+    uint64_t cur_ns = now_();
+    size_t n = 0;
+    if (cur_ns != 0)
+    {
+        size_t qsize = qsize_;
+        if constexpr (Policy::concurrent)
+        {
+            // Резервируем место сразу под весь пакет, конкурируя только с lock-free созданием
+            do
+                n = std::min<size_t>(count, maxTimers() - std::min<size_t>(qsize, maxTimers()));
+            while (!qsize_.compare_exchange_weak(qsize, qsize + n));
+        }
+        else
+        {
+            n = std::min<size_t>(count, maxTimers() - qsize);
+            qsize_ += n;
+        }
+        if (n != 0)
+            record(queue_depth_, qsize + n, n);
+    }
+    if (n != 0)
+    {
+        drainSubmitted();
+        uint64_t min_ns = std::numeric_limits<uint64_t>::max();
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint64_t slack_ns = timers[i].slack_ns == TimerRequest::DEFAULT_SLACK ? slack_ns_.load(std::memory_order_relaxed)
+                                                                                : timers[i].slack_ns;
+            uint64_t due_ns = timers[i].ns + cur_ns;
+            uint64_t ns = timer_detail::applySlack(due_ns, slack_ns);
+            min_ns = std::min(min_ns, ns);
+            uint32_t slot = slab_.alloc();
+            uint64_t id = slab_.handle(slot);
+            slab_[slot] = AsyncTimerTask(ns, std::move(timers[i].cb), id, timers[i].is_async);
+            slab_[slot].group = timers[i].group;
+            slab_[slot].rounded = ns != due_ns;
+            slab_[slot].slack_log2 = timer_detail::slackLog2(slack_ns);
+            batch_.push_back(slot);
+            infos[i] = {id, cur_ns, ns};
+        }
+        tasks_queue_->pushBatch(batch_.data(), n);
+        for (uint32_t slot : batch_)
+            linkGroup(slot);
+        batch_.clear();
+        if (lock.owns_lock() && min_ns < wake_ns_.load())
+            wakeDispatcher();
+    }
+    for (size_t i = n; i < count; ++i)
+        infos[i] = {};
+    if (cur_ns != 0 && n < count)
+        rejected_.fetch_add(count - n, std::memory_order_relaxed);
+    return n;
+}
+
+template <typename Policy>
+bool BasicAsyncTimer<Policy>::deleteTimer(uint64_t id)
+{
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    if (running())
+        lock.lock();
+    uint32_t slot = slab_.find(id);
+    if (slot == TimerSlab::NIL)
+        return false;
+    drainSubmitted();
+    if (tasks_queue_->remove(slot))
+    {
+        releaseSlot(slot);
+        return true;
+    }
+    return cancelExpired(slot);
+}
+
+template <typename Policy>
+size_t BasicAsyncTimer<Policy>::deleteTimers(const uint64_t *ids, size_t count)
+{
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    if (running())
+        lock.lock();
+    drainSubmitted();
+    size_t ret = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t slot = slab_.find(ids[i]);
+        if (slot == TimerSlab::NIL)
+            continue;
+        if (tasks_queue_->remove(slot))
+        {
+            releaseSlot(slot);
+            ret++;
+        }
+        else if (cancelExpired(slot))
+            ret++;
+    }
+    return ret;
+}
+
+template <typename Policy>
+size_t BasicAsyncTimer<Policy>::cancelGroup(uint64_t group)
+{
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    if (running())
+        lock.lock();
+    drainSubmitted();
+    if (!groups_)
+        return 0;
+    size_t ret = 0;
+    // Группа снимается целиком, освобождение узлов уже не трогает таблицу групп
+    for (uint32_t slot = groups_->detach(group); slot != TimerGroups::NIL;)
+    {
+        uint32_t next = groups_->release(slot);
+        if (tasks_queue_->remove(slot))
+        {
+            releaseSlot(slot);
+            ret++;
+        }
+        else if (cancelExpired(slot))
+            ret++;
+        slot = next;
+    }
+    return ret;
+}
+
+template <typename Policy>
+TimerInfo BasicAsyncTimer<Policy>::rescheduleTimer(uint64_t id, uint64_t new_delay_ns)
+{
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    if (running())
+        lock.lock();
+    uint32_t slot = slab_.find(id);
+    uint64_t cur_ns = 0;
+    if (cur_ns = now_(); cur_ns == 0 || slot == TimerSlab::NIL)
+        return {};
+    drainSubmitted();
+    // Новое время округляется допуском таймера, заданным при создании
+    uint64_t due_ns = cur_ns + new_delay_ns;
+    uint8_t slack_log2 = slab_[slot].slack_log2;
+    uint64_t ns = timer_detail::applySlack(due_ns, slack_log2 ? 1ull << slack_log2 : 0);
+    if (!tasks_queue_->reschedule(slot, ns))
+        return {};
+    slab_[slot].rounded = ns != due_ns;
+    if (lock.owns_lock() && ns < wake_ns_.load())
+        wakeDispatcher();
+    return {id, cur_ns, ns};
+}
+
+template <typename Policy>
+bool BasicAsyncTimer<Policy>::cancelExpired(uint32_t slot)
+{
+    // Периодический таймер, задание которого сейчас выполняется: отменяем перезапуск
+    if (slab_[slot].period_ns == 0 || std::find(expired_.begin(), expired_.end(), slot) == expired_.end())
+        return false;
+    if (std::find(cancelled_.begin(), cancelled_.end(), slot) != cancelled_.end())
+        return false;
+    cancelled_.push_back(slot);
+    return true;
+}
+
+template <typename Policy>
+size_t BasicAsyncTimer<Policy>::takeExpired(uint64_t pass_ns)
+{
+    uint32_t slot = 0;
+    bool rounded = false;
+    while (expired_.size() < EXPIRED_BATCH && tasks_queue_->popExpired(pass_ns, slot))
+    {
+        const AsyncTimerTask &task = slab_[slot];
+        if (task.is_async && task.cb && !workers_)
+            workers_ = std::make_unique<WorkerPool>(worker_params_);
+        rounded = rounded || task.rounded;
+        expired_.push_back(slot);
+    }
+    if (rounded && expired_.size() > 1)
+        wakeups_saved_.fetch_add(savedWakeups(), std::memory_order_relaxed);
+    return expired_.size();
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::runExpired()
+{
+    // Время окончания задания - время начала следующего
+    uint64_t cur_ns = now_();
+    for (uint32_t slot : expired_)
+    {
+        AsyncTimerTask &task = slab_[slot];
+        record(lateness_, cur_ns > task.ns ? cur_ns - task.ns : 0);
+        if (task.cb)
+        {
+            if (!task.is_async)
+                task.cb();
+            else
+                workers_->submit(std::move(task.cb));
+        }
+        uint64_t start_ns = cur_ns;
+        cur_ns = now_();
+        if (!task.is_async)
+            record(run_time_, cur_ns - start_ns);
+        if (task.period_ns != 0)
+            task.nextPeriod(cur_ns);
+    }
+    cur_ns_ = cur_ns;
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::rearmExpired()
+{
+    // Узел однократного таймера освобождается после выполнения задания, периодического - при отмене
+    for (uint32_t slot : expired_)
+    {
+        const AsyncTimerTask &task = slab_[slot];
+        if (task.period_ns != 0 && task.cb && std::find(cancelled_.begin(), cancelled_.end(), slot) == cancelled_.end())
+            tasks_queue_->push(slot);
+        else
+            releaseSlot(slot);
+    }
+    expired_.clear();
+    cancelled_.clear();
+}
+
+template <typename Policy>
+size_t BasicAsyncTimer<Policy>::checkTimers(std::unique_lock<std::mutex> &lock)
+{
+    size_t count = 0;
+    // Проход выполняет только таймеры, истекшие к его началу: иначе FixedRate с заданием дольше периода
+    // выполнял бы пропущенные периоды бесконечно. Истекшие во время прохода ждут следующего
+    const uint64_t pass_ns = cur_ns_;
+    // Задания извлекаются под мьютексом, а выполняются без него
+    while (size_t n = takeExpired(pass_ns))
+    {
+        count += n;
+        if (lock.owns_lock())
+        {
+            lock.unlock();
+            runExpired();
+            lock.lock();
+        }
+        else
+            runExpired();
+        rearmExpired();
+    }
+    return count;
+}
+
+template <typename Policy>
+uint64_t BasicAsyncTimer<Policy>::savedWakeups()
+{
+    // Из k таймеров с общим временем сработки k - 1 обошлись без своего пробуждения, но только те,
+    // которые попали на это время из-за допуска: совпадение точных таймеров пробуждений не экономит
+    deadlines_.clear();
+    for (uint32_t slot : expired_)
+        deadlines_.push_back({slab_[slot].ns, slab_[slot].rounded});
+    std::sort(deadlines_.begin(), deadlines_.end());
+    uint64_t saved = 0;
+    for (size_t i = 0, j = 0; i < deadlines_.size(); i = j)
+    {
+        uint64_t rounded = 0;
+        for (; j < deadlines_.size() && deadlines_[j].first == deadlines_[i].first; ++j)
+            rounded += deadlines_[j].second;
+        saved += std::min<uint64_t>(j - i - 1, rounded);
+    }
+    return saved;
+}
+
+template <typename Policy>
+size_t BasicAsyncTimer<Policy>::checkTimersAt(uint64_t cur_ns)
+{
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    drainSubmitted();
+    cur_ns_ = cur_ns;
+    return checkTimers(lock);
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::adoptSlot(uint32_t slot)
+{
+    // Узел выделен и заполнен другим потоком, место в очереди гарантирует пул
+    tasks_queue_->push(slot);
+    linkGroup(slot);
+    record(queue_depth_, ++qsize_);
+}
+
+template <typename Policy>
+typename BasicAsyncTimer<Policy>::Stats BasicAsyncTimer<Policy>::stats(bool reset)
+{
+    return {lateness_.snapshot(reset), run_time_.snapshot(reset), queue_depth_.snapshot(reset),
+            reset ? wakeups_saved_.exchange(0) : wakeups_saved_.load(),
+            reset ? wakeups_.exchange(0) : wakeups_.load(),
+            reset ? spurious_wakeups_.exchange(0) : spurious_wakeups_.load(),
+            reset ? rejected_.exchange(0) : rejected_.load()};
+}
+
+template <typename Policy>
+bool BasicAsyncTimer<Policy>::setWorkerPool(const WorkerPool::Params &params)
+{
+    // runExpired передает задания в пул без мьютекса, поэтому при работающем цикле пул не заменяется
+    if (running())
+        return false;
+    // Конструктор пула выделяет очередь и запускает потоки, поэтому выполняется без мьютекса;
+    // прежний пул останавливается после освобождения мьютекса
+    auto pool = std::make_unique<WorkerPool>(params);
+    std::lock_guard lock(mtx_);
+    if (running())
+        return false;
+    worker_params_ = params;
+    workers_.swap(pool);
+    return true;
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::startWorkers()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (workers_)
+        return;
+    WorkerPool::Params params = worker_params_;
+    lock.unlock();
+    auto pool = std::make_unique<WorkerPool>(params);
+    lock.lock();
+    if (!workers_)
+        workers_.swap(pool);
+}
+
+template <typename Policy>
+WorkerPool::Stats BasicAsyncTimer<Policy>::workerPoolStats() const
+{
+    std::lock_guard lock(mtx_);
+    if (!workers_)
+        return {};
+    return workers_->stats();
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::checkTimersNow()
+{
+    if (running())
+    {
+        // std::lock_guard<std::mutex> lock(mtx_);
+        wakeDispatcher();
+    }
+    else
+    {
+        uint64_t cur_ns = 0;
+        if (cur_ns = now_(); cur_ns != 0)
+        {
+            std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+            drainSubmitted();
+            cur_ns_ = cur_ns;
+            checkTimers(lock);
+        }
+    }
+}
+
+template <typename Policy>
+uint64_t BasicAsyncTimer<Policy>::nextDeadline()
+{
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    if (running())
+        lock.lock();
+    drainSubmitted();
+    return tasks_queue_->nextTime();
+}
+
+template <typename Policy>
+size_t BasicAsyncTimer<Policy>::advanceClock(uint64_t ns)
+{
+    // ManualClock общий для процесса: таймер с другим источником не должен сдвигать время чужих таймеров
+    if (!timer_detail::isManualClock(now_))
+        return 0;
+    uint64_t until_ns = ManualClock::now() + ns;
+    if (running())
+    {
+        ManualClock::set(until_ns);
+        std::lock_guard lock(mtx_);
+        wakeDispatcher();
+        return 0;
+    }
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    size_t count = 0;
+    drainSubmitted();
+    // Время переводится на каждую сработку, поэтому задания видят в now() свое расчетное время
+    for (uint64_t next = tasks_queue_->nextTime(); next <= until_ns; next = tasks_queue_->nextTime())
+    {
+        cur_ns_ = std::max(next, ManualClock::now());
+        ManualClock::set(cur_ns_);
+        count += checkTimers(lock);
+    }
+    ManualClock::set(std::max(until_ns, ManualClock::now()));
+    return count;
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::wakeDispatcher()
+{
+    wake_seq_.fetch_add(1, std::memory_order_relaxed);
+    if (event_fd_ >= 0)
+        timer_detail::signalFd(event_fd_);
+    else
+        new_timer_event_.notify_one();
+}
+
+template <typename Policy>
+int BasicAsyncTimer<Policy>::openPollFd()
+{
+    // Таймер без синхронизации не перевзводит timerfd при создании таймеров
+    if constexpr (!Policy::concurrent)
+        return -1;
+    startWorkers();
+    std::lock_guard lock(mtx_);
+    if (poll_fd_ >= 0)
+        return poll_fd_;
+    poll_fd_ = timer_detail::openPollFds(timer_fd_, event_fd_);
+    if (poll_fd_ < 0)
+        return -1;
+    drainSubmitted();
+    armPollTimer(tasks_queue_->empty() ? std::numeric_limits<uint64_t>::max() : tasks_queue_->nextTime());
+    running_.store(true);
+    return poll_fd_;
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::closePollFd()
+{
+    timer_detail::closeFd(poll_fd_);
+    timer_detail::closeFd(timer_fd_);
+    timer_detail::closeFd(event_fd_);
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::armPollTimer(uint64_t next_ns)
+{
+    uint64_t ns = std::numeric_limits<uint64_t>::max();
+    if (next_ns != ns)
+    {
+        // Интервал относительный, поэтому подходит любой источник времени; 0 выключил бы таймер
+        uint64_t cur_ns = now_();
+        ns = next_ns > cur_ns ? next_ns - cur_ns : 1;
+    }
+    timer_detail::armTimerFd(timer_fd_, ns);
+    wake_ns_.store(next_ns, std::memory_order_relaxed);
+}
+
+template <typename Policy>
+size_t BasicAsyncTimer<Policy>::processExpired()
+{
+    // Сброс готовности дескрипторов, read не блокируется
+    timer_detail::readFd(timer_fd_);
+    timer_detail::readFd(event_fd_);
+    size_t count = 0;
+    std::unique_lock<std::mutex> lock(mtx_);
+    wake_ns_.store(0, std::memory_order_relaxed);
+    for (;;)
+    {
+        drainSubmitted();
+        if (uint64_t cur_ns = now_(); cur_ns != 0)
+        {
+            cur_ns_ = cur_ns;
+            count += checkTimers(lock);
+        }
+        armPollTimer(tasks_queue_->empty() ? std::numeric_limits<uint64_t>::max() : tasks_queue_->nextTime());
+        // Парный барьер в createTimer_: новые таймеры после проверки очереди передачи разбудят владельца
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (submit_queue_.size() == 0)
+            break;
+        wake_ns_.store(0, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::setTimerSlack(uint64_t slack_ns)
+{
+    // Читается при создании таймера без мьютекса
+    slack_ns_.store(slack_ns, std::memory_order_relaxed);
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::setOverflowPolicy(OverflowPolicy policy, uint64_t block_timeout_ns)
+{
+    block_timeout_ns_.store(block_timeout_ns, std::memory_order_relaxed);
+    overflow_policy_.store(policy, std::memory_order_relaxed);
+}
+
+template <typename Policy>
+uint32_t BasicAsyncTimer<Policy>::shrinkCapacity()
+{
+    // Поиск по id выполняется под мьютексом, поэтому освобождаемые сегменты никто не читает
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    if (running())
+        lock.lock();
+    return slab_.shrink();
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::setPrecisionMode(uint64_t spin_ns)
+{
+    std::lock_guard lock(mtx_);
+    spin_ns_ = spin_ns;
+}
+
+template <typename Policy>
+uint64_t BasicAsyncTimer<Policy>::spinUntil(uint64_t deadline_ns, uint64_t wake_seq, const std::atomic_bool &terminate) const
+{
+    uint64_t cur_ns = now_();
+    while (cur_ns < deadline_ns && submit_queue_.size() == 0 && wake_seq_.load(std::memory_order_relaxed) == wake_seq &&
+           !terminate.load(std::memory_order_relaxed))
+    {
+        timer_detail::cpuRelax();
+        cur_ns = now_();
+    }
+    return cur_ns;
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::run(std::atomic_bool &terminate)
+{
+    bool woke = false;         // Итерация после пробуждения уведомлением, а не по таймауту
+    uint64_t slept_next_ns = 0; // Ближайший таймер перед сном
+    std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+    // Первое асинхронное задание не ждет создания пула под мьютексом
+    startWorkers();
+    running_.store(true);
+    while (!terminate.load(std::memory_order_relaxed))
+    {
+        uint64_t cur_ns = now_();
+        if (cur_ns == 0)
+            continue;
+        lock.lock();
+        drainSubmitted();
+        cur_ns_ = cur_ns;
+        size_t fired = checkTimers(lock);
+        uint64_t next_ns = tasks_queue_->nextTime();
+        if (woke && fired == 0 && next_ns == slept_next_ns)
+            spurious_wakeups_.fetch_add(1, std::memory_order_relaxed);
+        woke = false;
+        // Таймеры, истекшие во время checkTimers, проверяются без сна (timeout 0)
+        uint64_t timeout = next_ns == std::numeric_limits<uint64_t>::max() ? next_ns : next_ns - std::min(next_ns, cur_ns_);
+        if (spin_ns_ != 0 && timeout <= spin_ns_)
+        {
+            // Последние spin_ns_ до сработки опрашиваем часы и очередь передачи без сна. Таймеры раньше next_ns,
+            // добавленные под мьютексом или перенесенные rescheduleTimer, прерывают ожидание через wakeDispatcher
+            wake_ns_.store(next_ns, std::memory_order_relaxed);
+            uint64_t wake_seq = wake_seq_.load(std::memory_order_relaxed);
+            lock.unlock();
+            cur_ns = spinUntil(next_ns, wake_seq, terminate);
+            lock.lock();
+            wake_ns_.store(0, std::memory_order_relaxed);
+            drainSubmitted();
+            cur_ns_ = cur_ns;
+            checkTimers(lock);
+            lock.unlock();
+            continue;
+        }
+        if (timeout != std::numeric_limits<uint64_t>::max())
+            timeout -= spin_ns_;
+        wake_ns_.store(timeout == std::numeric_limits<uint64_t>::max() ? timeout : cur_ns_ + timeout, std::memory_order_relaxed);
+        // Парный барьер в createTimer_; terminate проверяется под мьютексом, который захватывает wake()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (timeout != 0 && submit_queue_.size() == 0 && !terminate.load(std::memory_order_relaxed))
+        {
+            // Пустая очередь: сон до создания таймера или wake(). Пробуждение по таймауту (в том числе по
+            // пределу MAX_SLEEP_NS до дальнего таймера) не считается ложным
+            if (timeout == std::numeric_limits<uint64_t>::max())
+            {
+                new_timer_event_.wait(lock);
+                woke = true;
+            }
+            else
+                woke = new_timer_event_.wait_for(lock, std::chrono::nanoseconds(std::min(timeout, MAX_SLEEP_NS))) ==
+                       std::cv_status::no_timeout;
+            wakeups_.fetch_add(1, std::memory_order_relaxed);
+            slept_next_ns = next_ns;
+        }
+        wake_ns_.store(0, std::memory_order_relaxed);
+        lock.unlock();
+    }
+    running_.store(false);
+    lock.lock();
+    drainSubmitted();
+}
+
+template <typename Policy>
+void BasicAsyncTimer<Policy>::wake()
+{
+    std::lock_guard lock(mtx_);
+    new_timer_event_.notify_one();
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include "InlineCallback.h"
+#include "Clock.h"
+
+/**
+ * @brief Режим перезапуска периодического таймера
+ *
+ */
+enum class PeriodicPolicy : uint8_t
+{
+    FixedRate,     ///< Без накопления сдвига (от расчетного времени), пропущенные периоды выполняются подряд
+                   ///< (за проход проверки - только истекшие к его началу)
+    FixedRateSkip, ///< Без накопления сдвига (от расчетного времени), пропущенные периоды пропускаются
+    FixedDelay     ///< Следующий период отсчитывается от окончания выполнения задания
+};
+/**
+ * @brief Задание таймера
+ *
+ */
+struct alignas(64) AsyncTimerTask
+{
+    using Cb = InlineCallback<ASYNC_TIMER_CB_CAPACITY>;
+    uint64_t ns = 0;                                   ///< Время сработки таймера в наносекундах
+    bool is_async = false;                             ///< Асинхронное выполнение задания
+    PeriodicPolicy policy = PeriodicPolicy::FixedRate; ///< Режим перезапуска периодического таймера
+    bool rounded = false;                              ///< Время сработки сдвинуто допуском таймера
+    uint8_t slack_log2 = 0;                            ///< log2 сетки допуска таймера (applySlack), 0 - точный таймер
+    Cb cb;                                             ///< Задание таймера
+    uint64_t id = 0;                                   ///< id таймера
+    uint64_t period_ns = 0;                            ///< Период в наносекундах, 0 - однократный таймер
+    uint64_t group = 0;                                ///< Группа таймера (BasicAsyncTimer::cancelGroup), 0 - без группы
+
+    AsyncTimerTask() = default;
+    AsyncTimerTask(const AsyncTimerTask &o) = delete;
+    AsyncTimerTask(AsyncTimerTask &&o) = default;
+    AsyncTimerTask &operator=(const AsyncTimerTask &o) = delete;
+    AsyncTimerTask &operator=(AsyncTimerTask &&o) = default;
+    AsyncTimerTask(uint64_t ns, Cb &&cb, uint64_t id, bool is_async = false) : ns(ns), is_async(is_async), cb(std::move(cb)), id(id){};
+    ~AsyncTimerTask() = default;
+    bool operator<(const AsyncTimerTask &o) const { return ns < o.ns; }
+    bool operator>(const AsyncTimerTask &o) const { return ns > o.ns; }
+    bool operator==(const AsyncTimerTask &o) const { return ns == o.ns; }
+    /**
+     * @brief Расчет следующего времени сработки периодического таймера
+     *
+     * @param now_ns Время окончания выполнения задания в наносекундах
+     */
+    void nextPeriod(uint64_t now_ns)
+    {
+        if (policy == PeriodicPolicy::FixedDelay)
+            ns = now_ns + period_ns;
+        else if (policy == PeriodicPolicy::FixedRateSkip && ns + period_ns <= now_ns)
+            ns += ((now_ns - ns) / period_ns + 1) * period_ns;
+        else
+            ns += period_ns;
+    }
+    /**
+     * @brief Запуск задания таймера
+     *
+     */
+    void run() const
+    {
+        if (cb)
+            cb();
+    }
+};
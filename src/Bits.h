@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Номер младшего установленного бита, v != 0
+ *
+ */
+inline uint32_t ctz64(uint64_t v)
+{
+#ifdef _MSC_VER
+    unsigned long idx = 0;
+    _BitScanForward64(&idx, v);
+    return static_cast<uint32_t>(idx);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(v));
+#endif
+}
+
+/**
+ * @brief Номер старшего установленного бита, v != 0
+ *
+ */
+inline uint32_t msb64(uint64_t v)
+{
+#ifdef _MSC_VER
+    unsigned long idx = 0;
+    _BitScanReverse64(&idx, v);
+    return static_cast<uint32_t>(idx);
+#else
+    return 63 - static_cast<uint32_t>(__builtin_clzll(v));
+#endif
+}
@@ -0,0 +1,142 @@
+#include "Clock.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#ifdef __linux__
+#include <time.h>
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+#define ASYNC_TIMER_HAS_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+uint64_t getTimeNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+namespace
+{
+    std::atomic<uint64_t> g_manual_ns{1'000'000'000};
+
+    uint64_t systemTimeNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+#ifdef __linux__
+    uint64_t coarseTimeNs()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+    }
+#endif
+
+#ifdef ASYNC_TIMER_HAS_TSC
+    /**
+     * @brief Перевод тактов в наносекунды: ns = base_ns + ((tsc - base_tsc) * mult) >> 32
+     *
+     */
+    struct TscCalibration
+    {
+        uint64_t base_tsc = 0;
+        uint64_t base_ns = 0;
+        uint64_t mult = 0;
+    };
+    TscCalibration g_tsc;
+    std::once_flag g_tsc_once;
+
+    bool hasInvariantTsc()
+    {
+#ifdef _MSC_VER
+        int regs[4] = {};
+        __cpuid(regs, 0x80000000);
+        if (static_cast<unsigned>(regs[0]) < 0x80000007)
+            return false;
+        __cpuid(regs, 0x80000007);
+        return (regs[3] & (1 << 8)) != 0;
+#else
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (edx & (1u << 8)) != 0;
+#endif
+    }
+
+    void calibrateTsc()
+    {
+        uint64_t ns0 = getTimeNs();
+        uint64_t tsc0 = __rdtsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        uint64_t ns1 = getTimeNs();
+        uint64_t tsc1 = __rdtsc();
+        if (tsc1 <= tsc0)
+            return;
+        g_tsc.mult = ((ns1 - ns0) << 32) / (tsc1 - tsc0);
+        g_tsc.base_tsc = tsc1;
+        g_tsc.base_ns = ns1;
+    }
+
+    uint64_t tscTimeNs()
+    {
+        uint64_t delta = __rdtsc() - g_tsc.base_tsc;
+#ifdef _MSC_VER
+        uint64_t high = 0;
+        uint64_t low = _umul128(delta, g_tsc.mult, &high);
+        return g_tsc.base_ns + ((high << 32) | (low >> 32));
+#else
+        return g_tsc.base_ns + static_cast<uint64_t>((static_cast<unsigned __int128>(delta) * g_tsc.mult) >> 32);
+#endif
+    }
+#endif
+} // namespace
+
+uint64_t ManualClock::now()
+{
+    return g_manual_ns.load(std::memory_order_acquire);
+}
+
+void ManualClock::set(uint64_t ns)
+{
+    g_manual_ns.store(ns, std::memory_order_release);
+}
+
+void ManualClock::advance(uint64_t ns)
+{
+    g_manual_ns.fetch_add(ns, std::memory_order_acq_rel);
+}
+
+ClockFn getClock(ClockSource source)
+{
+    switch (source)
+    {
+    case ClockSource::Manual:
+        return &ManualClock::now;
+    case ClockSource::System:
+        return &systemTimeNs;
+    case ClockSource::MonotonicCoarse:
+#ifdef __linux__
+        return &coarseTimeNs;
+#else
+        return &getTimeNs;
+#endif
+    case ClockSource::Tsc:
+#ifdef ASYNC_TIMER_HAS_TSC
+        if (!hasInvariantTsc())
+            return &getTimeNs;
+        std::call_once(g_tsc_once, calibrateTsc);
+        return g_tsc.mult ? &tscTimeNs : &getTimeNs;
+#else
+        return &getTimeNs;
+#endif
+    default:
+        return &getTimeNs;
+    }
+}
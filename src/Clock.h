@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Источник времени таймера
+ *
+ * Все источники, кроме System, монотонны и не зависят от коррекции системного времени.
+ */
+enum class ClockSource
+{
+    Steady,          ///< std::chrono::steady_clock
+    MonotonicCoarse, ///< CLOCK_MONOTONIC_COARSE (Linux), точность - тик ядра; на других ОС Steady
+    Tsc,             ///< Счетчик тактов процессора, откалиброванный по Steady; без invariant TSC - Steady
+    System,          ///< std::chrono::system_clock, подвержен коррекции системного времени
+    Manual           ///< ManualClock: виртуальное время, изменяется только явно (тесты, моделирование)
+};
+
+/**
+ * @brief Функция получения текущего времени в наносекундах
+ *
+ */
+using ClockFn = uint64_t (*)();
+
+/**
+ * @brief Функция получения текущего времени в наносекундах (std::chrono::steady_clock)
+ *
+ * @return uint64_t Кол-во наносекунд
+ */
+uint64_t getTimeNs();
+/**
+ * @brief Получение функции времени для источника
+ *
+ * @param source Источник времени
+ * @return ClockFn Функция времени
+ * Для ClockSource::Tsc при первом вызове выполняется калибровка (~20 мс).
+ */
+ClockFn getClock(ClockSource source);
+
+/**
+ * @brief Виртуальное время для тестов и моделирования
+ *
+ * Одно время на процесс: его читают все таймеры с ClockSource::Manual и с Policy::Clock = ManualClock,
+ * поэтому set, advance и AsyncTimer::advanceClock любого из них сдвигают время всех остальных. Для
+ * независимых сценариев нужны таймеры, не работающие одновременно, или set перед каждым сценарием.
+ * Время меняется только через set/advance, начальное значение - 1 секунда (0 таймер считает ошибкой часов).
+ * Запущенный цикл проверки не видит изменения времени до checkTimersNow(); без цикла проверки
+ * AsyncTimer::advanceClock выполняет таймеры точно в их время без ожидания.
+ */
+class ManualClock
+{
+public:
+    explicit ManualClock(ClockSource) {}
+    uint64_t operator()() const { return now(); }
+    /**
+     * @brief Текущее виртуальное время в наносекундах
+     *
+     */
+    static uint64_t now();
+    /**
+     * @brief Установка виртуального времени
+     *
+     * @param ns Время в наносекундах, больше 0; перевод назад допускается только между сценариями
+     */
+    static void set(uint64_t ns);
+    /**
+     * @brief Сдвиг виртуального времени вперед на ns наносекунд
+     *
+     */
+    static void advance(uint64_t ns);
+};
@@ -0,0 +1,176 @@
+#include "HeapTimerQueue.h"
+#include <limits>
+#include <new>
+
+HeapTimerQueue::HeapTimerQueue(TimerSlab &slab)
+    : slab_(slab),
+      pos_(slab.capacity(), NIL),
+      mem_(static_cast<Entry *>(::operator new(sizeof(Entry) * (slab.capacity() + ARITY - 1), std::align_val_t(64)))),
+      heap_(mem_ + ARITY - 1),
+      size_(0)
+{
+}
+
+HeapTimerQueue::~HeapTimerQueue()
+{
+    ::operator delete(mem_, std::align_val_t(64));
+}
+
+uint32_t HeapTimerQueue::minChild(uint32_t first) const
+{
+    if (first + ARITY <= size_)
+    {
+        // Полная группа потомков: турнир без ветвлений
+        const Entry *c = heap_ + first;
+        uint32_t a = c[1].key < c[0].key ? 1 : 0;
+        uint32_t b = c[3].key < c[2].key ? 3 : 2;
+        return first + (c[b].key < c[a].key ? b : a);
+    }
+    uint32_t best = first;
+    for (uint32_t i = first + 1; i < size_; ++i)
+        if (heap_[i].key < heap_[best].key)
+            best = i;
+    return best;
+}
+
+void HeapTimerQueue::siftUp(uint32_t pos, Entry e)
+{
+    // Перемещение "дырки" вместо обменов: каждая пара записывается один раз
+    while (pos > 0)
+    {
+        uint32_t parent = (pos - 1) / ARITY;
+        if (!(e.key < heap_[parent].key))
+            break;
+        place(pos, heap_[parent]);
+        pos = parent;
+    }
+    place(pos, e);
+}
+
+void HeapTimerQueue::siftDown(uint32_t pos, Entry e)
+{
+    for (;;)
+    {
+        uint32_t first = ARITY * pos + 1;
+        if (first >= size_)
+            break;
+        uint32_t child = minChild(first);
+        if (!(heap_[child].key < e.key))
+            break;
+        place(pos, heap_[child]);
+        pos = child;
+    }
+    place(pos, e);
+}
+
+void HeapTimerQueue::removeAt(uint32_t pos)
+{
+    uint32_t slot = heap_[pos].slot;
+    uint32_t last = --size_;
+    if (pos != last)
+    {
+        Entry e = heap_[last];
+        if (pos > 0 && e.key < heap_[(pos - 1) / ARITY].key)
+            siftUp(pos, e);
+        else
+            siftDown(pos, e);
+    }
+    pos_[slot] = NIL;
+}
+
+bool HeapTimerQueue::push(uint32_t slot)
+{
+    if (pos_[slot] != NIL)
+        return false;
+    siftUp(size_++, {slab_[slot].ns, slot});
+    return true;
+}
+
+size_t HeapTimerQueue::pushBatch(const uint32_t *slots, size_t count)
+{
+    uint32_t old_size = size_;
+    size_t ret = 0;
+    for (; ret < count && pos_[slots[ret]] == NIL; ++ret)
+        place(size_++, {slab_[slots[ret]].ns, slots[ret]});
+    if (size_ - old_size > old_size)
+    {
+        for (uint32_t pos = size_ / ARITY + 1; pos-- > 0;)
+            if (pos < size_)
+                siftDown(pos, heap_[pos]);
+    }
+    else
+    {
+        for (uint32_t pos = old_size; pos < size_; ++pos)
+            siftUp(pos, heap_[pos]);
+    }
+    settleTop();
+    return ret;
+}
+
+void HeapTimerQueue::settleTop()
+{
+    // Отложенное опускание перенесенных заданий: после него ключ вершины равен времени ее задания
+    while (size_ != 0)
+    {
+        const Entry &top = heap_[0];
+        uint64_t ns = slab_[top.slot].ns;
+        if (top.key == ns)
+            break;
+        siftDown(0, {ns, top.slot});
+    }
+}
+
+bool HeapTimerQueue::popExpired(uint64_t now_ns, uint32_t &slot)
+{
+    if (size_ == 0 || heap_[0].key > now_ns)
+        return false;
+    slot = heap_[0].slot;
+    removeAt(0);
+    settleTop();
+    return true;
+}
+
+bool HeapTimerQueue::remove(uint32_t slot)
+{
+    if (pos_[slot] == NIL)
+        return false;
+    removeAt(pos_[slot]);
+    settleTop();
+    return true;
+}
+
+bool HeapTimerQueue::reschedule(uint32_t slot, uint64_t ns)
+{
+    uint32_t pos = pos_[slot];
+    if (pos == NIL)
+        return false;
+    slab_[slot].ns = ns;
+    if (ns < heap_[pos].key)
+        siftUp(pos, {ns, slot});
+    else if (pos == 0)
+        settleTop();
+    return true;
+}
+
+uint64_t HeapTimerQueue::nextTime() const
+{
+    if (size_ == 0)
+        return std::numeric_limits<uint64_t>::max();
+    return heap_[0].key;
+}
+
+uint32_t HeapTimerQueue::latest() const
+{
+    uint32_t ret = NIL;
+    uint64_t ns = 0;
+    for (uint32_t pos = 0; pos < size_; ++pos)
+    {
+        uint32_t slot = heap_[pos].slot;
+        if (ret == NIL || slab_[slot].ns > ns)
+        {
+            ret = slot;
+            ns = slab_[slot].ns;
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <vector>
+#include "TimerQueue.h"
+
+/**
+ * @brief Очередь заданий на индексированной 4-арной куче
+ *
+ * Куча хранит пары (ключ, номер узла пула) по 16 байт, задания остаются в пуле, поэтому при просеивании
+ * сравниваются и перемещаются только пары. Четыре потомка узла занимают одну кэш-линию (память кучи
+ * выровнена на 64 байта со смещением корня), выбор минимального потомка выполняется без ветвлений.
+ * Каждый узел пула знает свою позицию в куче, что позволяет удалить задание за O(log n).
+ * Куча упорядочена по ключу, который может быть раньше времени задания: перенос на более
+ * позднее время только меняет время задания, узел опускается на место, когда доходит до вершины.
+ */
+class HeapTimerQueue final : public ITimerQueue
+{
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr uint32_t ARITY = 4;
+
+    struct Entry
+    {
+        uint64_t key;  ///< Ключ кучи, <= времени задания
+        uint32_t slot; ///< Номер узла пула
+    };
+    static_assert(sizeof(Entry) * ARITY == 64, "children of a heap node must fill one cache line");
+
+private:
+    TimerSlab &slab_;
+    std::vector<uint32_t> pos_; ///< Позиция в куче по номеру узла пула, NIL - задание не в очереди
+    Entry *mem_;                ///< Память кучи, выровнена на 64 байта
+    Entry *heap_;               ///< Корень кучи, mem_ + ARITY - 1: потомки 4i+1..4i+4 начинаются с границы кэш-линии
+    uint32_t size_;
+
+public:
+    /**
+     * @brief Конструктор с параметрами
+     *
+     * @param slab Пул заданий, емкость очереди равна его емкости
+     */
+    explicit HeapTimerQueue(TimerSlab &slab);
+    HeapTimerQueue(const HeapTimerQueue &) = delete;
+    HeapTimerQueue &operator=(const HeapTimerQueue &) = delete;
+    ~HeapTimerQueue();
+    bool push(uint32_t slot) override;
+    /**
+     * @brief Добавление нескольких заданий в очередь
+     *
+     * Если заданий больше, чем уже есть в куче, куча перестраивается целиком за O(n + k),
+     * иначе каждое задание поднимается на свое место за O(log n).
+     */
+    size_t pushBatch(const uint32_t *slots, size_t count) override;
+    bool popExpired(uint64_t now_ns, uint32_t &slot) override;
+    /**
+     * @brief Удаление задания из очереди
+     *
+     * O(log n)
+     */
+    bool remove(uint32_t slot) override;
+    /**
+     * @brief Перенос времени сработки задания
+     *
+     * Перенос на более позднее время O(1), узел опускается при достижении вершины кучи,
+     * на более раннее O(log n)
+     */
+    bool reschedule(uint32_t slot, uint64_t ns) override;
+    uint64_t nextTime() const override;
+    /**
+     * @brief Задание с самым поздним временем сработки
+     *
+     * Из-за отложенных ключей перенесенное задание может быть в любом узле, поэтому просматривается вся куча
+     */
+    uint32_t latest() const override;
+    size_t size() const override { return size_; }
+
+private:
+    void place(uint32_t pos, const Entry &e)
+    {
+        heap_[pos] = e;
+        pos_[e.slot] = pos;
+    }
+    uint32_t minChild(uint32_t first) const;
+    void siftUp(uint32_t pos, Entry e);
+    void siftDown(uint32_t pos, Entry e);
+    void removeAt(uint32_t pos);
+    void settleTop();
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "Bits.h"
+
+/**
+ * @brief Логарифмическая гистограмма значений (в стиле HDR Histogram)
+ *
+ * Каждая степень двойки делится на SUB_BUCKETS равных интервалов, относительная погрешность
+ * не превышает 1/SUB_BUCKETS. Запись lock-free и без выделения памяти, может выполняться
+ * из нескольких потоков одновременно со снимком и сбросом.
+ */
+class Histogram
+{
+public:
+    static constexpr uint32_t SUB_BITS = 5;
+    static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BITS;
+    static constexpr uint32_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+    /**
+     * @brief Снимок гистограммы
+     *
+     * Перцентили округляются вверх до границы интервала, но не больше max
+     */
+    struct Snapshot
+    {
+        uint64_t count = 0; ///< Количество значений
+        uint64_t sum = 0;   ///< Сумма значений
+        uint64_t p50 = 0;
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+        uint64_t max = 0;
+    };
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> counts_{};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+
+public:
+    /**
+     * @brief Запись значения
+     *
+     * @param v Значение
+     * @param count Количество одинаковых значений
+     */
+    void record(uint64_t v, uint64_t count = 1)
+    {
+        counts_[bucket(v)].fetch_add(count, std::memory_order_relaxed);
+        sum_.fetch_add(v * count, std::memory_order_relaxed);
+        uint64_t cur = max_.load(std::memory_order_relaxed);
+        while (cur < v && !max_.compare_exchange_weak(cur, v, std::memory_order_relaxed))
+        {
+        }
+    }
+    /**
+     * @brief Максимальное записанное значение
+     *
+     */
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    /**
+     * @brief Получение снимка гистограммы
+     *
+     * @param reset Обнулить гистограмму
+     * @return Snapshot
+     */
+    Snapshot snapshot(bool reset = false)
+    {
+        Snapshot ret;
+        std::array<uint64_t, BUCKETS> counts;
+        for (uint32_t i = 0; i < BUCKETS; ++i)
+        {
+            counts[i] = reset ? counts_[i].exchange(0, std::memory_order_relaxed) : counts_[i].load(std::memory_order_relaxed);
+            ret.count += counts[i];
+        }
+        ret.sum = reset ? sum_.exchange(0, std::memory_order_relaxed) : sum_.load(std::memory_order_relaxed);
+        ret.max = reset ? max_.exchange(0, std::memory_order_relaxed) : max_.load(std::memory_order_relaxed);
+        if (ret.count == 0)
+            return ret;
+        const uint64_t ranks[] = {(ret.count * 500 + 999) / 1000, (ret.count * 990 + 999) / 1000, (ret.count * 999 + 999) / 1000};
+        uint64_t *values[] = {&ret.p50, &ret.p99, &ret.p999};
+        uint64_t seen = 0;
+        uint32_t q = 0;
+        for (uint32_t i = 0; i < BUCKETS && q < 3; ++i)
+        {
+            seen += counts[i];
+            while (q < 3 && seen >= ranks[q])
+                *values[q++] = std::min(upperBound(i), ret.max);
+        }
+        return ret;
+    }
+
+private:
+    static uint32_t bucket(uint64_t v)
+    {
+        if (v < SUB_BUCKETS)
+            return static_cast<uint32_t>(v);
+        uint32_t shift = msb64(v) - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + static_cast<uint32_t>((v >> shift) - SUB_BUCKETS);
+    }
+    static uint64_t upperBound(uint32_t idx)
+    {
+        if (idx < SUB_BUCKETS)
+            return idx;
+        uint32_t shift = idx / SUB_BUCKETS - 1;
+        uint64_t low = static_cast<uint64_t>(SUB_BUCKETS + idx % SUB_BUCKETS) << shift;
+        return low + ((1ull << shift) - 1);
+    }
+};
@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef ASYNC_TIMER_CB_CAPACITY
+#define ASYNC_TIMER_CB_CAPACITY 48
+#endif
+
+/**
+ * @brief Перемещаемая функция без аргументов с хранением во встроенном буфере
+ *
+ * В отличие от std::function никогда не выделяет память в куче и не копируется: захваченное
+ * состояние обязано помещаться в Capacity байт (проверяется при компиляции).
+ *
+ * @tparam Capacity Размер встроенного буфера в байтах
+ */
+template <size_t Capacity>
+class InlineCallback
+{
+    struct VTable
+    {
+        void (*invoke)(void *);
+        void (*move)(void *dst, void *src) noexcept;
+        void (*destroy)(void *) noexcept;
+    };
+
+    template <typename Fn>
+    static void invokeImpl(void *p) { (*static_cast<Fn *>(p))(); }
+    template <typename Fn>
+    static void moveImpl(void *dst, void *src) noexcept
+    {
+        ::new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+        static_cast<Fn *>(src)->~Fn();
+    }
+    template <typename Fn>
+    static void destroyImpl(void *p) noexcept { static_cast<Fn *>(p)->~Fn(); }
+    template <typename Fn>
+    static constexpr VTable vtable_ = {&invokeImpl<Fn>, &moveImpl<Fn>, &destroyImpl<Fn>};
+
+    template <typename Fn>
+    static bool isEmpty(const Fn &f)
+    {
+        if constexpr (std::is_pointer_v<Fn> || std::is_member_pointer_v<Fn>)
+            return f == nullptr;
+        else if constexpr (std::is_same_v<Fn, std::function<void()>>)
+            return !f;
+        else
+            return false;
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    const VTable *vt_ = nullptr;
+
+public:
+    static constexpr size_t capacity = Capacity;
+
+    InlineCallback() noexcept = default;
+    InlineCallback(std::nullptr_t) noexcept {}
+    /**
+     * @brief Конструктор из вызываемого объекта
+     *
+     * @param f Вызываемый объект, размер которого не превышает Capacity
+     */
+    template <typename F, typename Fn = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<Fn, InlineCallback> && std::is_invocable_r_v<void, Fn &>>>
+    InlineCallback(F &&f)
+    {
+        static_assert(sizeof(Fn) <= Capacity, "Callback state exceeds ASYNC_TIMER_CB_CAPACITY");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "Callback is over-aligned");
+        static_assert(std::is_nothrow_move_constructible_v<Fn>, "Callback must be nothrow move constructible");
+        if (isEmpty(f))
+            return;
+        ::new (static_cast<void *>(storage_)) Fn(std::forward<F>(f));
+        vt_ = &vtable_<Fn>;
+    }
+    InlineCallback(InlineCallback &&o) noexcept
+    {
+        if (o.vt_)
+        {
+            o.vt_->move(storage_, o.storage_);
+            vt_ = o.vt_;
+            o.vt_ = nullptr;
+        }
+    }
+    InlineCallback &operator=(InlineCallback &&o) noexcept
+    {
+        if (&o != this)
+        {
+            reset();
+            if (o.vt_)
+            {
+                o.vt_->move(storage_, o.storage_);
+                vt_ = o.vt_;
+                o.vt_ = nullptr;
+            }
+        }
+        return *this;
+    }
+    InlineCallback(const InlineCallback &) = delete;
+    InlineCallback &operator=(const InlineCallback &) = delete;
+    ~InlineCallback() { reset(); }
+    /**
+     * @brief Уничтожение хранимого объекта
+     *
+     */
+    void reset() noexcept
+    {
+        if (vt_)
+        {
+            vt_->destroy(storage_);
+            vt_ = nullptr;
+        }
+    }
+    explicit operator bool() const noexcept { return vt_ != nullptr; }
+    void operator()() const { vt_->invoke(const_cast<unsigned char *>(storage_)); }
+};
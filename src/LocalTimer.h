@@ -0,0 +1,159 @@
+#pragma once
+#include "AsyncTimer.h"
+
+/**
+ * @brief Параметры LocalTimer по умолчанию: без синхронизации и статистики, куча без виртуальных вызовов
+ *
+ */
+struct LocalTimerPolicy
+{
+    static constexpr uint32_t max_timers = 0;
+    static constexpr bool concurrent = false;
+    static constexpr bool stats = false;
+    using Clock = SteadyClock;
+    using Queue = HeapTimerQueue;
+};
+
+/**
+ * @brief Таймер потока цикла событий (reactor, игровой цикл)
+ *
+ * Все методы, кроме post, вызываются из потока-владельца и не используют мьютекс, условную переменную и
+ * атомарные счетчики. Цикл владельца спит до nextDeadline() и вызывает poll(). Ядро планировщика
+ * (пул заданий, очередь, выполнение и перезапуск заданий) общее с AsyncTimer.
+ * Другие потоки создают таймеры через post - lock-free входящую очередь, которую владелец разбирает при
+ * следующем вызове любого метода. post не будит владельца: если цикл спит до nextDeadline(), его нужно
+ * разбудить средствами цикла (например eventfd).
+ *
+ * @tparam Policy Параметры времени компиляции, Policy::concurrent должен быть false
+ */
+template <typename Policy = LocalTimerPolicy>
+class BasicLocalTimer
+{
+    static_assert(!Policy::concurrent, "LocalTimer is single-threaded");
+
+    BasicAsyncTimer<Policy> core_;
+    std::unique_ptr<MpmcQueue<uint32_t>> inbox_; ///< Таймеры, созданные другими потоками, nullptr - post выключен
+
+public:
+    /**
+     * @brief Конструктор с параметрами
+     *
+     * @param max_timers Максимальное количество таймеров (если не задано в Policy::max_timers)
+     * @param inbox_size Емкость входящей очереди для post, 0 - post выключен
+     * @param clock Источник времени (для Policy::Clock = DynamicClock)
+     */
+    explicit BasicLocalTimer(uint32_t max_timers, uint32_t inbox_size = 0, ClockSource clock = ClockSource::Steady)
+        : core_(max_timers, 0, TimerBackend::Heap, {}, clock),
+          inbox_(inbox_size ? std::make_unique<MpmcQueue<uint32_t>>(inbox_size) : nullptr)
+    {
+    }
+    BasicLocalTimer(const BasicLocalTimer &) = delete;
+    BasicLocalTimer &operator=(const BasicLocalTimer &) = delete;
+    /**
+     * @brief Текущее время источника таймера, в нем задаются poll и TimerInfo
+     *
+     */
+    uint64_t now() const { return core_.now_(); }
+    TimerInfo createNanoTimer(uint64_t ns, AsyncTimerTask::Cb &&cb)
+    {
+        drainInbox();
+        return core_.createNanoTimer(ns, std::move(cb));
+    }
+    TimerInfo createPeriodicTimer(uint64_t period_ns, AsyncTimerTask::Cb &&cb,
+                                  PeriodicPolicy policy = PeriodicPolicy::FixedRate)
+    {
+        drainInbox();
+        return core_.createPeriodicTimer(period_ns, std::move(cb), policy);
+    }
+    TimerInfo createGroupTimer(uint64_t group, uint64_t ns, AsyncTimerTask::Cb &&cb)
+    {
+        drainInbox();
+        return core_.createGroupTimer(group, ns, std::move(cb));
+    }
+    bool deleteTimer(uint64_t id)
+    {
+        drainInbox();
+        return core_.deleteTimer(id);
+    }
+    size_t cancelGroup(uint64_t group)
+    {
+        drainInbox();
+        return core_.cancelGroup(group);
+    }
+    TimerInfo rescheduleTimer(uint64_t id, uint64_t new_delay_ns)
+    {
+        drainInbox();
+        return core_.rescheduleTimer(id, new_delay_ns);
+    }
+    void setTimerSlack(uint64_t slack_ns) { core_.slack_ns_.store(slack_ns, std::memory_order_relaxed); }
+    /**
+     * @brief Выполнение заданий таймеров, истекших к моменту now
+     *
+     * @param now Время источника таймера (now())
+     * @return size_t Количество выполненных заданий
+     */
+    size_t poll(uint64_t now)
+    {
+        drainInbox();
+        return core_.checkTimersAt(now);
+    }
+    size_t poll() { return poll(now()); }
+    /**
+     * @brief Моделирование: сдвиг ManualClock с выполнением таймеров точно в их время (AsyncTimer::advanceClock)
+     *
+     */
+    size_t advanceClock(uint64_t ns)
+    {
+        drainInbox();
+        return core_.advanceClock(ns);
+    }
+    /**
+     * @brief Время, не позднее которого нужно вызвать poll
+     *
+     * @return uint64_t Время источника таймера, UINT64_MAX если таймеров нет
+     */
+    uint64_t nextDeadline()
+    {
+        drainInbox();
+        return core_.tasks_queue_->nextTime();
+    }
+    size_t size() const { return core_.qsize_; }
+    /**
+     * @brief Создание таймера из любого потока (lock-free)
+     *
+     * Таймер попадает в очередь владельца при следующем вызове его метода, допуск таймера не применяется.
+     * @return TimerInfo id = 0, если post выключен, пул или входящая очередь заполнены
+     */
+    TimerInfo post(uint64_t ns, AsyncTimerTask::Cb &&cb)
+    {
+        if (!inbox_)
+            return {};
+        uint64_t cur_ns = core_.now_();
+        if (cur_ns == 0)
+            return {};
+        // Пул lock-free, поэтому узел выделяется в вызывающем потоке; занятый узел владелец не трогает
+        uint32_t slot = core_.slab_.alloc();
+        if (slot == TimerSlab::NIL)
+            return {};
+        AsyncTimerTask task(ns + cur_ns, std::move(cb), core_.slab_.handle(slot));
+        TimerInfo ret(task.id, cur_ns, task.ns);
+        core_.slab_[slot] = std::move(task);
+        if (!inbox_->tryPush(std::move(slot)))
+        {
+            core_.slab_[slot] = AsyncTimerTask();
+            core_.slab_.free(slot);
+            return {};
+        }
+        return ret;
+    }
+
+private:
+    void drainInbox()
+    {
+        uint32_t slot = 0;
+        while (inbox_ && inbox_->tryPop(slot))
+            core_.adoptSlot(slot);
+    }
+};
+
+using LocalTimer = BasicLocalTimer<>;
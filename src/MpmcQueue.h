@@ -0,0 +1,129 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Ограниченная lock-free очередь с несколькими производителями и потребителями
+ *
+ * Кольцевой буфер с порядковыми номерами ячеек (алгоритм Д. Вьюкова). Емкость округляется вверх
+ * до степени двойки. Операции не блокируются: при заполнении tryPush возвращает false, при
+ * отсутствии элементов tryPop возвращает false.
+ *
+ * @tparam T Тип элемента (достаточно перемещаемости)
+ */
+template <typename T>
+class MpmcQueue
+{
+    struct alignas(64) Cell
+    {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+public:
+    /**
+     * @brief Конструктор с параметрами
+     *
+     * @param capacity Минимальная емкость очереди
+     */
+    explicit MpmcQueue(size_t capacity)
+        : mask_(roundUp(capacity) - 1),
+          cells_(new Cell[mask_ + 1]),
+          head_(0),
+          tail_(0)
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    MpmcQueue(const MpmcQueue &) = delete;
+    MpmcQueue &operator=(const MpmcQueue &) = delete;
+    /**
+     * @brief Добавление элемента
+     *
+     * @param v Элемент
+     * @return true Элемент добавлен
+     * @return false Очередь заполнена, v не изменен
+     */
+    bool tryPush(T &&v)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells_[pos & mask_];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.data = std::move(v);
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+    /**
+     * @brief Извлечение элемента
+     *
+     * @param v Извлеченный элемент
+     * @return true Элемент извлечен
+     * @return false Очередь пуста
+     */
+    bool tryPop(T &v)
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells_[pos & mask_];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    v = std::move(cell.data);
+                    cell.data = T();
+                    cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+    /**
+     * @brief Приблизительное количество элементов
+     *
+     */
+    size_t size() const
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    static size_t roundUp(size_t v)
+    {
+        size_t ret = 2;
+        while (ret < v)
+            ret <<= 1;
+        return ret;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> head_;
+    alignas(64) std::atomic<size_t> tail_;
+};
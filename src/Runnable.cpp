@@ -49,7 +49,7 @@ namespace running
         }
         ~Impl()
         {
-            terminated_.store(true);
+            stop();
             if (thread_.joinable())
             {
                 if (thread_.get_id() == std::this_thread::get_id())
@@ -59,6 +59,12 @@ namespace running
             }
         }
 
+        void stop()
+        {
+            terminated_.store(true);
+            raw_object_pointer_->wake();
+        }
+
         static void run(Impl *thread, IRunnable *runnable_object, int &core_id)
         {
             try
@@ -79,7 +85,8 @@ namespace running
             while (!thread->terminated_.load())
             {
                 runnable_object->run(thread->terminated_);
-                std::this_thread::sleep_for(std::chrono::seconds(1));
+                if (!thread->terminated_.load())
+                    std::this_thread::sleep_for(std::chrono::seconds(1));
             }
         }
 
@@ -120,6 +127,6 @@ namespace running
         : pimpl_(std::make_unique<Impl>(runnable_object, core_id)) {}
     AutoThread::~AutoThread() { terminate(); }
     bool AutoThread::terminated() const { return pimpl_->terminated_.load(); }
-    void AutoThread::terminate() { pimpl_->terminated_.store(true); }
+    void AutoThread::terminate() { pimpl_->stop(); }
     int AutoThread::getCoreId() const { return pimpl_->core_id_; };
 } // namespace running
\ No newline at end of file
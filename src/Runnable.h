@@ -17,6 +17,14 @@ namespace running
          * @param terminate Переменная для остановки потока извне
          */
         virtual void run(std::atomic_bool &terminate) = 0;
+        /**
+         * @brief Пробуждение основного метода после установки terminate
+         *
+         * Вызывается при остановке потока (AutoThread::terminate), чтобы run, ожидающий событий, сразу увидел
+         * terminate. Код, запускающий run в своем потоке, после установки terminate тоже вызывает wake(),
+         * иначе run, ожидающий без таймаута, не остановится.
+         */
+        virtual void wake() {}
     };
 
     using RunnablePtr = std::unique_ptr<IRunnable>;
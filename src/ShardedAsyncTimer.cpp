@@ -0,0 +1,80 @@
+#include "ShardedAsyncTimer.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+ShardedAsyncTimer::ShardedAsyncTimer(const Params &params)
+{
+    uint32_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+    uint32_t shards = std::clamp<uint32_t>(params.shards ? params.shards : cores, 1, MAX_SHARDS);
+    shards_.reserve(shards);
+    threads_.reserve(shards);
+    core_to_shard_.resize(cores);
+    for (uint32_t i = 0; i < cores; ++i)
+        core_to_shard_[i] = i % shards;
+    for (uint32_t i = 0; i < shards; ++i)
+    {
+        shards_.push_back(std::make_unique<AsyncTimer>(params.max_timers, params.check_interval_ns, params.backend,
+                                                       params.wheel_params, params.clock, params.segment_size));
+        int core_id = params.core_ids.empty() ? -1 : params.core_ids[i % params.core_ids.size()];
+        // Производители на ядре шарда попадают в него же
+        if (core_id >= 0 && static_cast<uint32_t>(core_id) < cores)
+            core_to_shard_[core_id] = i;
+        threads_.push_back(std::make_unique<running::AutoThread>(shards_[i].get(), core_id));
+    }
+    // До запуска run() шард создает таймеры без мьютекса, поэтому производители получают таймер после старта
+    for (auto &shard : shards_)
+        while (!shard->isRunning())
+            std::this_thread::yield();
+}
+
+ShardedAsyncTimer::~ShardedAsyncTimer()
+{
+    for (auto &thr : threads_)
+        thr->terminate();
+    threads_.clear();
+    shards_.clear();
+}
+
+uint32_t ShardedAsyncTimer::currentShard() const
+{
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && static_cast<size_t>(cpu) < core_to_shard_.size())
+        return core_to_shard_[cpu];
+#endif
+    return static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()) % shards_.size());
+}
+
+TimerInfo ShardedAsyncTimer::create(uint32_t shard, uint64_t ns, AsyncTimerTask::Cb &&cb, bool is_async)
+{
+    TimerInfo ret = shards_[shard]->createNanoTimer(ns, std::move(cb), is_async);
+    if (ret.id)
+        ret.id |= static_cast<uint64_t>(shard) << (64 - SHARD_BITS);
+    return ret;
+}
+
+TimerInfo ShardedAsyncTimer::createNanoTimer(uint64_t ns, AsyncTimerTask::Cb &&cb, bool is_async)
+{
+    return create(currentShard(), ns, std::move(cb), is_async);
+}
+
+TimerInfo ShardedAsyncTimer::createNanoTimerByKey(uint64_t key, uint64_t ns, AsyncTimerTask::Cb &&cb, bool is_async)
+{
+    // Перемешивание, чтобы последовательные ключи равномерно распределялись по шардам
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return create(static_cast<uint32_t>(key % shards_.size()), ns, std::move(cb), is_async);
+}
+
+bool ShardedAsyncTimer::deleteTimer(uint64_t id)
+{
+    uint64_t shard = id >> (64 - SHARD_BITS);
+    if (shard >= shards_.size())
+        return false;
+    return shards_[shard]->deleteTimer(id & LOCAL_ID_MASK);
+}
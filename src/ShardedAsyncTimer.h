@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include "AsyncTimer.h"
+
+/**
+ * @brief Многоядерный таймер из нескольких независимых AsyncTimer (шардов)
+ *
+ * Каждый шард обслуживается своим потоком running::AutoThread с необязательной привязкой к ядру.
+ * Таймер создается в шарде текущего ядра или в шарде, выбранном по ключу. Номер шарда хранится в
+ * старших битах id таймера, поэтому удаление сразу обращается к нужному шарду.
+ */
+class ShardedAsyncTimer
+{
+public:
+    static constexpr uint32_t SHARD_BITS = 8;                                 ///< Бит id под номер шарда
+    static constexpr uint32_t MAX_SHARDS = 1u << SHARD_BITS;                  ///< Максимальное количество шардов
+    static constexpr uint64_t LOCAL_ID_MASK = (1ull << (64 - SHARD_BITS)) - 1; ///< Маска id таймера внутри шарда
+    /**
+     * @brief Параметры шардов
+     *
+     */
+    struct Params
+    {
+        uint32_t shards = 0;                   ///< Количество шардов [1, MAX_SHARDS], 0 - по количеству ядер
+        uint32_t max_timers = 100'000;         ///< Максимальное количество таймеров в одном шарде
+        uint64_t check_interval_ns = 1'000'000; ///< Deprecated, не используется: цикл проверки спит до ближайшего таймера
+        std::vector<int> core_ids;             ///< Ядра для привязки шардов (по кругу), пусто - без привязки
+        TimerBackend backend = TimerBackend::Heap;
+        TimingWheel::Params wheel_params;
+        ClockSource clock = ClockSource::Steady;
+        uint32_t segment_size = 0;             ///< Рост пула шарда сегментами, 0 - пул на max_timers сразу
+    };
+
+private:
+    std::vector<std::unique_ptr<AsyncTimer>> shards_;
+    std::vector<std::unique_ptr<running::AutoThread>> threads_;
+    std::vector<uint32_t> core_to_shard_; ///< Шард для каждого ядра
+
+public:
+    /**
+     * @brief Конструктор с параметрами, запускает потоки шардов и дожидается запуска их циклов проверки
+     *
+     * @param params Параметры шардов
+     */
+    explicit ShardedAsyncTimer(const Params &params);
+    ShardedAsyncTimer(const ShardedAsyncTimer &) = delete;
+    ShardedAsyncTimer(ShardedAsyncTimer &&) = delete;
+    ShardedAsyncTimer &operator=(const ShardedAsyncTimer &) = delete;
+    ShardedAsyncTimer &operator=(ShardedAsyncTimer &&) = delete;
+    /**
+     * @brief Деструктор, останавливает потоки шардов и выполняет оставшиеся задания
+     *
+     */
+    ~ShardedAsyncTimer();
+    /**
+     * @brief Создание таймера в шарде текущего ядра
+     *
+     * @param ns ожидание в наносекундах
+     * @param cb функция выполняющаяся по истечении таймера
+     * @param is_async асинхронное выполнение задания
+     * @return TimerInfo информация о таймере, id = 0 в случае ошибки
+     */
+    TimerInfo createNanoTimer(uint64_t ns, AsyncTimerTask::Cb &&cb, bool is_async = false);
+    /**
+     * @brief Создание таймера в шарде, выбранном по ключу
+     *
+     * @param key ключ (например, id соединения), таймеры с одинаковым ключом попадают в один шард
+     * @param ns ожидание в наносекундах
+     * @param cb функция выполняющаяся по истечении таймера
+     * @param is_async асинхронное выполнение задания
+     * @return TimerInfo информация о таймере, id = 0 в случае ошибки
+     */
+    TimerInfo createNanoTimerByKey(uint64_t key, uint64_t ns, AsyncTimerTask::Cb &&cb, bool is_async = false);
+    /**
+     * @brief Удаление таймера
+     *
+     * @param id id таймера
+     * @return true Успешное удаление
+     * @return false Таймер не найден
+     */
+    bool deleteTimer(uint64_t id);
+    /**
+     * @brief Количество шардов
+     *
+     */
+    size_t shards() const { return shards_.size(); }
+    /**
+     * @brief Доступ к шарду (например, для счетчиков)
+     *
+     * @param index номер шарда
+     */
+    AsyncTimer &shard(size_t index) { return *shards_[index]; }
+
+private:
+    uint32_t currentShard() const;
+    TimerInfo create(uint32_t shard, uint64_t ns, AsyncTimerTask::Cb &&cb, bool is_async);
+};
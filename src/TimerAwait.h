@@ -0,0 +1,167 @@
+#pragma once
+#include "AsyncTimer.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>) && __has_include(<stop_token>)
+#define ASYNC_TIMER_COROUTINES 1
+#include <atomic>
+#include <coroutine>
+#include <optional>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Ожидание таймера в сопрограмме: co_await sleepFor(timer, ns)
+ *
+ * Объект ожидания хранится в кадре сопрограммы, задание таймера захватывает только указатель на
+ * него, поэтому ожидание не выделяет память. Сопрограмма возобновляется в потоке цикла проверки
+ * таймеров (или в потоке, запросившем отмену). Результат co_await: true - время истекло,
+ * false - ожидание отменено через stop_token или таймер не создан (очередь заполнена).
+ *
+ * @tparam Timer BasicAsyncTimer с любой политикой или BasicLocalTimer
+ */
+template <typename Timer>
+class BasicTimerSleep
+{
+    struct Cancel
+    {
+        BasicTimerSleep *self;
+        void operator()() const noexcept
+        {
+            // Удалить можно только еще не сработавший таймер, иначе сопрограмму возобновит его задание
+            if (self->timer_.deleteTimer(self->id_))
+            {
+                self->cancelled_ = true;
+                self->complete();
+            }
+        }
+    };
+
+    Timer &timer_;
+    uint64_t ns_;
+    std::stop_token token_;
+    std::coroutine_handle<> handle_;
+    uint64_t id_ = 0;
+    bool cancelled_ = false;
+    std::atomic<uint32_t> pending_{2}; ///< Завершение ожидания и выход из await_suspend, кто последний - возобновляет
+    std::optional<std::stop_callback<Cancel>> stop_cb_;
+
+    void complete()
+    {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            handle_.resume();
+    }
+
+public:
+    BasicTimerSleep(Timer &timer, uint64_t ns, std::stop_token token)
+        : timer_(timer), ns_(ns), token_(std::move(token)) {}
+    BasicTimerSleep(const BasicTimerSleep &) = delete;
+    BasicTimerSleep &operator=(const BasicTimerSleep &) = delete;
+
+    bool await_ready()
+    {
+        cancelled_ = token_.stop_requested();
+        return cancelled_;
+    }
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        handle_ = handle;
+        id_ = timer_.createNanoTimer(ns_, [this]()
+                                     { complete(); })
+                  .id;
+        if (!id_)
+        {
+            cancelled_ = true;
+            return false;
+        }
+        if (token_.stop_possible())
+            stop_cb_.emplace(token_, Cancel{this});
+        // Таймер мог сработать или быть отменен до выхода из await_suspend: тогда продолжаем без приостановки
+        return pending_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+    bool await_resume() const { return !cancelled_; }
+};
+
+using TimerSleep = BasicTimerSleep<AsyncTimer>;
+
+/**
+ * @brief Ожидание ns наносекунд в сопрограмме: co_await sleepFor(timer, ns, token)
+ *
+ * @param timer Таймер
+ * @param ns Ожидание в наносекундах
+ * @param token Отмена ожидания
+ * @return BasicTimerSleep Объект ожидания, результат co_await: true - время истекло, false - отменено
+ */
+template <typename Timer>
+BasicTimerSleep<Timer> sleepFor(Timer &timer, uint64_t ns, std::stop_token token = {})
+{
+    return BasicTimerSleep<Timer>(timer, ns, std::move(token));
+}
+
+/**
+ * @brief Ожидание до момента deadline_ns (время источника таймера) в сопрограмме
+ *
+ */
+template <typename Timer>
+BasicTimerSleep<Timer> sleepUntil(Timer &timer, uint64_t deadline_ns, std::stop_token token = {})
+{
+    uint64_t cur_ns = timer.now();
+    return BasicTimerSleep<Timer>(timer, deadline_ns > cur_ns ? deadline_ns - cur_ns : 0, std::move(token));
+}
+
+/**
+ * @brief Ограничение времени ожидания, см. withTimeout
+ *
+ */
+template <typename Timer, typename Awaiter>
+class TimerTimeout
+{
+    Timer &timer_;
+    uint64_t ns_;
+    std::stop_source stop_;
+    Awaiter inner_;
+    uint64_t id_ = 0;
+
+public:
+    template <typename MakeAwaiter>
+    TimerTimeout(Timer &timer, uint64_t ns, std::stop_source stop, MakeAwaiter &&make)
+        : timer_(timer), ns_(ns), stop_(std::move(stop)), inner_(std::forward<MakeAwaiter>(make)(stop_.get_token())) {}
+    TimerTimeout(const TimerTimeout &) = delete;
+    TimerTimeout &operator=(const TimerTimeout &) = delete;
+
+    bool await_ready() { return inner_.await_ready(); }
+    auto await_suspend(std::coroutine_handle<> handle)
+    {
+        // Задание захватывает копию stop_source (счетчик ссылок, без выделения памяти):
+        // сработка после завершения ожидания ни на что не влияет
+        id_ = timer_.createNanoTimer(ns_, [stop = stop_]() mutable
+                                     { stop.request_stop(); })
+                  .id;
+        return inner_.await_suspend(handle);
+    }
+    decltype(auto) await_resume()
+    {
+        if (id_)
+            timer_.deleteTimer(id_);
+        return inner_.await_resume();
+    }
+};
+
+/**
+ * @brief Ожидание с ограничением времени: co_await withTimeout(timer, ns, stop, [&](std::stop_token t) { return ...; })
+ *
+ * @param timer Таймер
+ * @param ns Ограничение времени в наносекундах
+ * @param stop Источник остановки вызывающего (операции или сессии), его токен получает вложенное ожидание
+ * @param make Функция, создающая объект ожидания (с методами await_*) с отменой по переданному stop_token
+ * По истечении ns запрашивается остановка stop, результат co_await - результат вложенного ожидания
+ * (для отмененного TimerSleep - false). Источник остановки создает вызывающий, поэтому withTimeout не
+ * выделяет память; после истечения времени stop остается остановленным.
+ */
+template <typename Timer, typename MakeAwaiter>
+auto withTimeout(Timer &timer, uint64_t ns, std::stop_source stop, MakeAwaiter &&make)
+{
+    using Awaiter = std::invoke_result_t<MakeAwaiter, std::stop_token>;
+    return TimerTimeout<Timer, Awaiter>(timer, ns, std::move(stop), std::forward<MakeAwaiter>(make));
+}
+#endif
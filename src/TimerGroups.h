@@ -0,0 +1,146 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "Bits.h"
+
+/**
+ * @brief Группы таймеров: интрузивные списки узлов пула по ключу группы
+ *
+ * Каждый узел пула входит не более чем в одну группу, ссылки списка хранятся в массивах по номеру узла.
+ * Голова списка группы находится по ключу в хеш-таблице с открытой адресацией (линейное пробирование,
+ * удаление со сдвигом без пометок), размер таблицы - степень двойки не меньше удвоенной емкости пула,
+ * поэтому память выделяется один раз в конструкторе. Все операции O(1), обход группы - O(размер группы).
+ * Ключ 0 означает "без группы".
+ */
+class TimerGroups
+{
+public:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+private:
+    struct Bucket
+    {
+        uint64_t tag = 0; ///< Ключ группы, 0 - свободная ячейка
+        uint32_t head = NIL;
+    };
+
+    const uint64_t mask_;
+    std::unique_ptr<Bucket[]> table_;
+    std::unique_ptr<uint64_t[]> tags_; ///< Группа узла, 0 - узел не в группе
+    std::unique_ptr<uint32_t[]> prev_;
+    std::unique_ptr<uint32_t[]> next_;
+
+public:
+    /**
+     * @brief Конструктор с параметрами
+     *
+     * @param capacity Емкость пула заданий
+     */
+    explicit TimerGroups(uint32_t capacity)
+        : mask_((1ull << (msb64(2ull * capacity + 1) + 1)) - 1),
+          table_(new Bucket[mask_ + 1]),
+          tags_(new uint64_t[capacity]()),
+          prev_(new uint32_t[capacity]),
+          next_(new uint32_t[capacity])
+    {
+    }
+    /**
+     * @brief Добавление узла в начало списка группы
+     *
+     */
+    void add(uint64_t tag, uint32_t slot)
+    {
+        Bucket &b = table_[find(tag)];
+        if (b.tag == 0)
+            b = {tag, NIL};
+        tags_[slot] = tag;
+        prev_[slot] = NIL;
+        next_[slot] = b.head;
+        if (b.head != NIL)
+            prev_[b.head] = slot;
+        b.head = slot;
+    }
+    /**
+     * @brief Удаление узла из списка его группы, пустая группа удаляется из таблицы
+     *
+     */
+    void remove(uint32_t slot)
+    {
+        uint64_t tag = tags_[slot];
+        if (tag == 0)
+            return;
+        tags_[slot] = 0;
+        if (next_[slot] != NIL)
+            prev_[next_[slot]] = prev_[slot];
+        if (prev_[slot] != NIL)
+        {
+            next_[prev_[slot]] = next_[slot];
+            return;
+        }
+        uint64_t pos = find(tag);
+        table_[pos].head = next_[slot];
+        if (table_[pos].head == NIL)
+            erase(pos);
+    }
+    /**
+     * @brief Удаление группы из таблицы целиком, один поиск по ключу
+     *
+     * @return uint32_t Первый узел бывшей группы или NIL; узлы обходятся через release
+     */
+    uint32_t detach(uint64_t tag)
+    {
+        if (tag == 0)
+            return NIL;
+        uint64_t pos = find(tag);
+        uint32_t head = table_[pos].head;
+        if (table_[pos].tag != 0)
+            erase(pos);
+        return head;
+    }
+    /**
+     * @brief Исключение узла отсоединенной группы
+     *
+     * @return uint32_t Следующий узел группы или NIL
+     */
+    uint32_t release(uint32_t slot)
+    {
+        tags_[slot] = 0;
+        return next_[slot];
+    }
+
+private:
+    static uint64_t hash(uint64_t tag)
+    {
+        // Перемешивание ключа (splitmix64), последовательные ключи не образуют кластеров
+        tag ^= tag >> 30;
+        tag *= 0xbf58476d1ce4e5b9ull;
+        tag ^= tag >> 27;
+        tag *= 0x94d049bb133111ebull;
+        return tag ^ (tag >> 31);
+    }
+    /**
+     * @brief Ячейка с ключом tag или свободная ячейка, в которую он попадет
+     *
+     */
+    uint64_t find(uint64_t tag) const
+    {
+        uint64_t pos = hash(tag) & mask_;
+        while (table_[pos].tag != 0 && table_[pos].tag != tag)
+            pos = (pos + 1) & mask_;
+        return pos;
+    }
+    void erase(uint64_t pos)
+    {
+        // Сдвиг следующих ключей цепочки на освободившееся место
+        for (uint64_t next = (pos + 1) & mask_; table_[next].tag != 0; next = (next + 1) & mask_)
+        {
+            uint64_t home = hash(table_[next].tag) & mask_;
+            if (((next - home) & mask_) >= ((next - pos) & mask_))
+            {
+                table_[pos] = table_[next];
+                pos = next;
+            }
+        }
+        table_[pos] = Bucket();
+    }
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include "Clock.h"
+#include "TimerQueue.h"
+
+/**
+ * @brief Источник времени, выбираемый в конструкторе таймера (ClockSource), вызов по указателю
+ *
+ */
+class DynamicClock
+{
+    ClockFn fn_;
+
+public:
+    explicit DynamicClock(ClockSource source) : fn_(getClock(source)) {}
+    uint64_t operator()() const { return fn_(); }
+    /**
+     * @brief Выбрано виртуальное время (ClockSource::Manual)
+     *
+     */
+    bool manual() const { return fn_ == &ManualClock::now; }
+};
+
+/**
+ * @brief std::chrono::steady_clock без косвенного вызова, параметр конструктора игнорируется
+ *
+ */
+class SteadyClock
+{
+public:
+    explicit SteadyClock(ClockSource) {}
+    uint64_t operator()() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+/**
+ * @brief Параметры BasicAsyncTimer по умолчанию (AsyncTimer)
+ *
+ * Политика - структура с теми же членами:
+ * - max_timers: емкость таймера, 0 - задается в конструкторе;
+ * - concurrent: false - все вызовы из одного потока (цикл проверки в нем же или checkTimersNow),
+ *   без мьютекса, очереди передачи и атомарной проверки running_ при создании и удалении таймера;
+ * - stats: запись гистограмм задержки, времени выполнения и глубины очереди;
+ * - Clock: источник времени, конструируется из ClockSource, operator()() возвращает наносекунды
+ *   (DynamicClock, SteadyClock или ManualClock для моделирования);
+ * - Queue: ITimerQueue - выбор TimerBackend в конструкторе, HeapTimerQueue или TimingWheel - очередь
+ *   без виртуальных вызовов.
+ * Размер встроенного буфера функции задания задается при сборке (ASYNC_TIMER_CB_CAPACITY).
+ */
+struct DefaultTimerPolicy
+{
+    static constexpr uint32_t max_timers = 0;
+    static constexpr bool concurrent = true;
+    static constexpr bool stats = true;
+    using Clock = DynamicClock;
+    using Queue = ITimerQueue;
+};
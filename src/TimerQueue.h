@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include "TimerSlab.h"
+
+/**
+ * @brief Интерфейс очереди заданий таймера
+ *
+ * Задания хранятся в пуле TimerSlab, очередь упорядочивает номера его узлов по времени сработки
+ * задания (AsyncTimerTask::ns). Емкость очереди равна емкости пула.
+ * Очередь не потокобезопасна, синхронизация выполняется владельцем (AsyncTimer).
+ */
+class ITimerQueue
+{
+public:
+    virtual ~ITimerQueue(){};
+    /**
+     * @brief Добавление задания в очередь
+     *
+     * @param slot Номер узла пула с заполненным заданием, не находящегося в очереди
+     * @return true Задание добавлено
+     * @return false Очередь заполнена
+     */
+    virtual bool push(uint32_t slot) = 0;
+    /**
+     * @brief Добавление нескольких заданий в очередь
+     *
+     * @param slots Массив номеров узлов пула
+     * @param count Количество заданий
+     * @return size_t Количество добавленных заданий (первые count), меньше count если очередь заполнена
+     */
+    virtual size_t pushBatch(const uint32_t *slots, size_t count)
+    {
+        size_t ret = 0;
+        while (ret < count && push(slots[ret]))
+            ret++;
+        return ret;
+    }
+    /**
+     * @brief Извлечение ближайшего задания, время которого наступило
+     *
+     * @param now_ns Текущее время в наносекундах
+     * @param slot Номер узла извлеченного задания, узел остается выделенным
+     * @return true Задание извлечено
+     * @return false Нет заданий со временем сработки <= now_ns
+     */
+    virtual bool popExpired(uint64_t now_ns, uint32_t &slot) = 0;
+    /**
+     * @brief Удаление задания из очереди
+     *
+     * @param slot Номер узла пула
+     * @return true Задание удалено, узел остается выделенным
+     * @return false Задание не находится в очереди
+     */
+    virtual bool remove(uint32_t slot) = 0;
+    /**
+     * @brief Перенос времени сработки задания
+     *
+     * @param slot Номер узла пула
+     * @param ns Новое время сработки в наносекундах
+     * @return true Время изменено, функция задания сохранена
+     * @return false Задание не находится в очереди
+     */
+    virtual bool reschedule(uint32_t slot, uint64_t ns) = 0;
+    /**
+     * @brief Время, не позднее которого нужно проверить очередь
+     *
+     * @return uint64_t Время в наносекундах, UINT64_MAX если очередь пуста
+     */
+    virtual uint64_t nextTime() const = 0;
+    /**
+     * @brief Задание с самым поздним временем сработки
+     *
+     * O(n), используется только при вытеснении из заполненной очереди
+     * @return uint32_t Номер узла пула, NIL если очередь пуста
+     */
+    virtual uint32_t latest() const = 0;
+    virtual size_t size() const = 0;
+    bool empty() const { return size() == 0; }
+};
+
+using TimerQueuePtr = std::unique_ptr<ITimerQueue>;
+
+/**
+ * @brief Тип очереди заданий таймера
+ *
+ */
+enum class TimerBackend
+{
+    Heap, ///< 4-арная индексированная куча с ленивыми ключами, O(log4 n) на вставку, удаление и сработку
+    Wheel ///< Иерархическое колесо таймеров, O(1) на вставку, удаление и сработку
+};
@@ -0,0 +1,271 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+#include "AsyncTimerTask.h"
+#include "Bits.h"
+
+#ifndef ASYNC_TIMER_HUGE_PAGES
+#define ASYNC_TIMER_HUGE_PAGES 0
+#endif
+
+/**
+ * @brief Пул заданий таймера
+ *
+ * Очереди заданий хранят только номера узлов. Свободные узлы образуют lock-free стек с счетчиком версий
+ * в вершине (защита от ABA), поэтому узел выделяется в потоке, создающем таймер, без мьютекса.
+ * Задания размещаются сегментами: без segment_size вся емкость выделяется в конструкторе, иначе сегменты
+ * по segment_size узлов добавляются, когда свободных узлов нет (без копирования существующих узлов),
+ * и освобождаются shrink. Мьютекс захватывается только при добавлении и освобождении сегментов.
+ * Дескриптор узла (id таймера): младшие 32 бита - номер узла, следующие GEN_BITS бит - поколение узла,
+ * которое увеличивается при освобождении. Устаревший дескриптор определяется за O(1) сравнением поколений,
+ * старшие 8 бит дескриптора всегда 0 (в них ShardedAsyncTimer хранит номер шарда). Поколения хранятся для
+ * всей емкости и переживают освобождение сегмента, поэтому дескрипторы не повторяются.
+ */
+class TimerSlab
+{
+public:
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr uint32_t GEN_BITS = 24;
+    static constexpr uint32_t GEN_MASK = (1u << GEN_BITS) - 1;
+
+private:
+    static constexpr size_t HUGE_PAGE_SIZE = 2u << 20;
+
+    const uint32_t capacity_;
+    const uint32_t shift_; ///< log2 размера сегмента
+    const bool huge_pages_;
+    std::unique_ptr<AsyncTimerTask *[]> segs_;
+    std::unique_ptr<size_t[]> mapped_bytes_; ///< Размер памяти сегмента, выделенной mmap, 0 - operator new
+    std::unique_ptr<std::atomic<uint32_t>[]> gens_;
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;
+    std::atomic<uint32_t> size_; ///< Узлы в выделенных сегментах, сегменты заняты подряд
+    std::mutex grow_mtx_;
+    alignas(64) std::atomic<uint64_t> head_; ///< Версия в старших 32 битах, номер узла в младших
+
+public:
+    /**
+     * @brief Конструктор с параметрами
+     *
+     * @param capacity Максимальное количество узлов
+     * @param segment_size Узлов в сегменте (округляется до степени двойки), 0 - вся емкость сразу
+     * @param huge_pages Разместить задания в прозрачных больших страницах (Linux, сегменты от 2 МБ)
+     */
+    explicit TimerSlab(uint32_t capacity, uint32_t segment_size = 0, bool huge_pages = ASYNC_TIMER_HUGE_PAGES)
+        : capacity_(capacity),
+          shift_(segment_size == 0 || segment_size >= capacity ? 31 : msb64(2ull * segment_size - 1)),
+          huge_pages_(huge_pages),
+          segs_(new AsyncTimerTask *[segments(capacity)]()),
+          mapped_bytes_(new size_t[segments(capacity)]()),
+          gens_(new std::atomic<uint32_t>[capacity]),
+          next_(new std::atomic<uint32_t>[capacity]),
+          size_(0),
+          head_(NIL)
+    {
+        for (uint32_t i = 0; i < capacity_; ++i)
+            gens_[i].store(1, std::memory_order_relaxed);
+        if (capacity_ != 0)
+            grow();
+    }
+    TimerSlab(const TimerSlab &) = delete;
+    TimerSlab &operator=(const TimerSlab &) = delete;
+    ~TimerSlab()
+    {
+        for (uint32_t seg = 0; seg < segments(size_.load()); ++seg)
+            releaseSegment(seg);
+    }
+    /**
+     * @brief Выделение узла, при отсутствии свободных добавляется сегмент
+     *
+     * @return uint32_t Номер узла или NIL, если выделена вся емкость
+     */
+    uint32_t alloc()
+    {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        for (;;)
+        {
+            uint32_t slot = static_cast<uint32_t>(head);
+            if (slot == NIL)
+            {
+                if (!grow())
+                    return NIL;
+                head = head_.load(std::memory_order_acquire);
+                continue;
+            }
+            uint64_t next = (((head >> 32) + 1) << 32) | next_[slot].load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(head, next, std::memory_order_acquire))
+                return slot;
+        }
+    }
+    /**
+     * @brief Освобождение узла, дескрипторы узла становятся недействительными
+     *
+     */
+    void free(uint32_t slot)
+    {
+        uint32_t gen = (gens_[slot].load(std::memory_order_relaxed) + 1) & GEN_MASK;
+        gens_[slot].store(gen ? gen : 1, std::memory_order_release);
+        push(slot, slot);
+    }
+    /**
+     * @brief Освобождение последних сегментов, все узлы которых свободны (первый сегмент сохраняется)
+     *
+     * @return uint32_t Количество освобожденных узлов
+     * Вызывающий гарантирует, что никто не обращается к узлам и не вызывает find одновременно
+     * (AsyncTimer - под своим мьютексом); alloc и free могут выполняться параллельно.
+     */
+    uint32_t shrink()
+    {
+        std::lock_guard lock(grow_mtx_);
+        // Забираем весь стек свободных узлов, параллельный alloc ждет на grow_mtx_
+        uint64_t head = head_.load(std::memory_order_acquire);
+        while (!head_.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | NIL, std::memory_order_acquire))
+            ;
+        uint32_t size = size_.load(std::memory_order_relaxed);
+        uint32_t count = segments(size);
+        std::vector<uint32_t> free_count(count);
+        for (uint32_t slot = static_cast<uint32_t>(head); slot != NIL; slot = next_[slot].load(std::memory_order_relaxed))
+            free_count[slot >> shift_]++;
+        uint32_t keep = count;
+        while (keep > 1 && free_count[keep - 1] == segmentLength(keep - 1))
+            keep--;
+        uint32_t new_size = std::min<uint32_t>(size, keep << shift_);
+        // Оставшиеся свободные узлы возвращаются в стек одной цепочкой
+        uint32_t first = NIL;
+        uint32_t last = NIL;
+        for (uint32_t slot = static_cast<uint32_t>(head); slot != NIL; slot = next_[slot].load(std::memory_order_relaxed))
+        {
+            if (slot >= new_size)
+                continue;
+            if (last == NIL)
+                first = slot;
+            else
+                next_[last].store(slot, std::memory_order_relaxed);
+            last = slot;
+        }
+        size_.store(new_size, std::memory_order_release);
+        for (uint32_t seg = keep; seg < count; ++seg)
+            releaseSegment(seg);
+        if (first != NIL)
+            push(first, last);
+        return size - new_size;
+    }
+    /**
+     * @brief Дескриптор выделенного узла
+     *
+     */
+    uint64_t handle(uint32_t slot) const
+    {
+        return (static_cast<uint64_t>(gens_[slot].load(std::memory_order_relaxed)) << 32) | slot;
+    }
+    /**
+     * @brief Номер узла по дескриптору
+     *
+     * @return uint32_t Номер узла или NIL, если дескриптор устарел или некорректен
+     */
+    uint32_t find(uint64_t handle) const
+    {
+        uint32_t slot = static_cast<uint32_t>(handle);
+        if (slot >= size_.load(std::memory_order_acquire) || (handle >> 32) != gens_[slot].load(std::memory_order_acquire))
+            return NIL;
+        return slot;
+    }
+    AsyncTimerTask &operator[](uint32_t slot) { return segs_[slot >> shift_][slot & ((1u << shift_) - 1)]; }
+    const AsyncTimerTask &operator[](uint32_t slot) const { return segs_[slot >> shift_][slot & ((1u << shift_) - 1)]; }
+    /**
+     * @brief Максимальное количество узлов
+     *
+     */
+    uint32_t capacity() const { return capacity_; }
+    /**
+     * @brief Количество узлов в выделенных сегментах
+     *
+     */
+    uint32_t size() const { return size_.load(std::memory_order_relaxed); }
+
+private:
+    uint32_t segments(uint32_t slots) const { return static_cast<uint32_t>((uint64_t(slots) + (1ull << shift_) - 1) >> shift_); }
+    uint32_t segmentLength(uint32_t seg) const
+    {
+        return static_cast<uint32_t>(std::min<uint64_t>(1ull << shift_, capacity_ - (uint64_t(seg) << shift_)));
+    }
+    /**
+     * @brief Добавление цепочки свободных узлов first..last (связанной через next_) в стек
+     *
+     */
+    void push(uint32_t first, uint32_t last)
+    {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        do
+            next_[last].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | first, std::memory_order_release));
+    }
+    /**
+     * @brief Добавление сегмента
+     *
+     * @return true В стеке есть свободные узлы
+     * @return false Выделена вся емкость
+     */
+    bool grow()
+    {
+        std::lock_guard lock(grow_mtx_);
+        if (static_cast<uint32_t>(head_.load(std::memory_order_acquire)) != NIL)
+            return true;
+        uint32_t base = size_.load(std::memory_order_relaxed);
+        if (base >= capacity_)
+            return false;
+        uint32_t seg = base >> shift_;
+        uint32_t len = segmentLength(seg);
+        size_t bytes = sizeof(AsyncTimerTask) * len;
+        AsyncTimerTask *tasks = nullptr;
+#ifdef __linux__
+        if (huge_pages_ && bytes >= HUGE_PAGE_SIZE)
+        {
+            size_t size = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+            void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p != MAP_FAILED)
+            {
+                madvise(p, size, MADV_HUGEPAGE);
+                tasks = static_cast<AsyncTimerTask *>(p);
+                mapped_bytes_[seg] = size;
+            }
+        }
+#endif
+        if (!tasks)
+            tasks = static_cast<AsyncTimerTask *>(::operator new(bytes, std::align_val_t(alignof(AsyncTimerTask))));
+        for (uint32_t i = 0; i < len; ++i)
+        {
+            new (tasks + i) AsyncTimerTask();
+            next_[base + i].store(base + i + 1, std::memory_order_relaxed);
+        }
+        segs_[seg] = tasks;
+        size_.store(base + len, std::memory_order_release);
+        push(base, base + len - 1);
+        return true;
+    }
+    void releaseSegment(uint32_t seg)
+    {
+        AsyncTimerTask *tasks = segs_[seg];
+        uint32_t len = segmentLength(seg);
+        for (uint32_t i = 0; i < len; ++i)
+            tasks[i].~AsyncTimerTask();
+        segs_[seg] = nullptr;
+#ifdef __linux__
+        if (mapped_bytes_[seg])
+        {
+            munmap(tasks, mapped_bytes_[seg]);
+            mapped_bytes_[seg] = 0;
+            return;
+        }
+#endif
+        ::operator delete(tasks, std::align_val_t(alignof(AsyncTimerTask)));
+    }
+};
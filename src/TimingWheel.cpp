@@ -0,0 +1,216 @@
+#include "TimingWheel.h"
+#include "Bits.h"
+#include <algorithm>
+#include <limits>
+
+TimingWheel::TimingWheel(TimerSlab &slab, const Params &params, uint64_t start_ns)
+    : slab_(slab),
+      tick_ns_(std::max<uint64_t>(params.tick_ns, 1)),
+      levels_(std::clamp<uint32_t>(params.levels, 1, MAX_LEVELS)),
+      overflow_list_(levels_ * SLOTS),
+      nodes_(slab.capacity()),
+      heads_(levels_ * SLOTS + 1, NIL),
+      occupied_(levels_, 0),
+      size_(0),
+      cur_tick_(start_ns / tick_ns_)
+{
+}
+
+void TimingWheel::link(uint32_t idx, uint32_t list)
+{
+    Node &n = nodes_[idx];
+    n.list = list;
+    n.prev = NIL;
+    n.next = heads_[list];
+    if (n.next != NIL)
+        nodes_[n.next].prev = idx;
+    heads_[list] = idx;
+    if (list != overflow_list_)
+        occupied_[list / SLOTS] |= 1ull << (list % SLOTS);
+}
+
+void TimingWheel::unlink(uint32_t idx)
+{
+    Node &n = nodes_[idx];
+    if (n.prev != NIL)
+        nodes_[n.prev].next = n.next;
+    else
+        heads_[n.list] = n.next;
+    if (n.next != NIL)
+        nodes_[n.next].prev = n.prev;
+    if (heads_[n.list] == NIL && n.list != overflow_list_)
+        occupied_[n.list / SLOTS] &= ~(1ull << (n.list % SLOTS));
+    n.prev = n.next = NIL;
+    n.list = NIL;
+}
+
+void TimingWheel::place(uint32_t idx)
+{
+    uint64_t tick = std::max(slab_[idx].ns / tick_ns_, cur_tick_);
+    uint64_t diff = tick ^ cur_tick_;
+    uint32_t level = diff ? msb64(diff) / SLOT_BITS : 0;
+    if (level >= levels_)
+        link(idx, overflow_list_);
+    else
+        link(idx, level * SLOTS + static_cast<uint32_t>((tick >> (level * SLOT_BITS)) & SLOT_MASK));
+}
+
+bool TimingWheel::push(uint32_t slot)
+{
+    if (nodes_[slot].list != NIL)
+        return false;
+    size_++;
+    place(slot);
+    return true;
+}
+
+bool TimingWheel::remove(uint32_t slot)
+{
+    if (nodes_[slot].list == NIL)
+        return false;
+    unlink(slot);
+    size_--;
+    return true;
+}
+
+bool TimingWheel::reschedule(uint32_t slot, uint64_t ns)
+{
+    if (nodes_[slot].list == NIL)
+        return false;
+    unlink(slot);
+    slab_[slot].ns = ns;
+    place(slot);
+    return true;
+}
+
+void TimingWheel::cascade()
+{
+    if (heads_[overflow_list_] != NIL && (cur_tick_ & ((1ull << (levels_ * SLOT_BITS)) - 1)) == 0)
+    {
+        uint32_t idx = heads_[overflow_list_];
+        heads_[overflow_list_] = NIL;
+        while (idx != NIL)
+        {
+            uint32_t next = nodes_[idx].next;
+            place(idx);
+            idx = next;
+        }
+    }
+    for (uint32_t level = levels_ - 1; level > 0; --level)
+    {
+        uint32_t shift = level * SLOT_BITS;
+        if ((cur_tick_ & ((1ull << shift) - 1)) != 0)
+            continue;
+        uint32_t list = level * SLOTS + static_cast<uint32_t>((cur_tick_ >> shift) & SLOT_MASK);
+        uint32_t idx = heads_[list];
+        if (idx == NIL)
+            continue;
+        heads_[list] = NIL;
+        occupied_[level] &= ~(1ull << (list % SLOTS));
+        while (idx != NIL)
+        {
+            uint32_t next = nodes_[idx].next;
+            place(idx);
+            idx = next;
+        }
+    }
+}
+
+uint64_t TimingWheel::nextEventTick(uint32_t &level) const
+{
+    for (level = 0; level < levels_; ++level)
+    {
+        uint32_t shift = level * SLOT_BITS;
+        uint64_t slot = (cur_tick_ >> shift) & SLOT_MASK;
+        if (slot == SLOT_MASK)
+            continue;
+        uint64_t mask = occupied_[level] & (~0ull << (slot + 1));
+        if (mask)
+        {
+            uint64_t base = (cur_tick_ >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+            return base | (static_cast<uint64_t>(ctz64(mask)) << shift);
+        }
+    }
+    if (heads_[overflow_list_] != NIL)
+    {
+        uint32_t shift = levels_ * SLOT_BITS;
+        return ((cur_tick_ >> shift) + 1) << shift;
+    }
+    return std::numeric_limits<uint64_t>::max();
+}
+
+uint64_t TimingWheel::minInList(uint32_t list) const
+{
+    uint64_t ret = std::numeric_limits<uint64_t>::max();
+    for (uint32_t idx = heads_[list]; idx != NIL; idx = nodes_[idx].next)
+        ret = std::min(ret, slab_[idx].ns);
+    return ret;
+}
+
+bool TimingWheel::popExpired(uint64_t now_ns, uint32_t &slot)
+{
+    uint64_t now_tick = now_ns / tick_ns_;
+    if (size_ == 0)
+    {
+        // Пустое колесо можно сразу перевести на текущий тик
+        cur_tick_ = std::max(cur_tick_, now_tick);
+        return false;
+    }
+    for (;;)
+    {
+        for (uint32_t idx = heads_[cur_tick_ & SLOT_MASK]; idx != NIL; idx = nodes_[idx].next)
+        {
+            if (slab_[idx].ns <= now_ns)
+            {
+                unlink(idx);
+                size_--;
+                slot = idx;
+                return true;
+            }
+        }
+        if (cur_tick_ >= now_tick)
+            return false;
+        uint32_t level = 0;
+        uint64_t next = nextEventTick(level);
+        if (next > now_tick)
+        {
+            cur_tick_ = now_tick;
+            return false;
+        }
+        cur_tick_ = next;
+        cascade();
+    }
+}
+
+uint64_t TimingWheel::nextTime() const
+{
+    if (size_ == 0)
+        return std::numeric_limits<uint64_t>::max();
+    uint64_t ret = minInList(static_cast<uint32_t>(cur_tick_ & SLOT_MASK));
+    if (ret != std::numeric_limits<uint64_t>::max())
+        return ret;
+    uint32_t level = 0;
+    uint64_t next = nextEventTick(level);
+    if (level == 0)
+        return minInList(static_cast<uint32_t>(next & SLOT_MASK));
+    return next * tick_ns_;
+}
+
+uint32_t TimingWheel::latest() const
+{
+    // Колесо переходит на текущий тик без опускания заданий, поэтому просматриваются все списки
+    uint32_t ret = NIL;
+    uint64_t ns = 0;
+    for (uint32_t list = 0; list <= overflow_list_; ++list)
+    {
+        for (uint32_t idx = heads_[list]; idx != NIL; idx = nodes_[idx].next)
+        {
+            if (ret == NIL || slab_[idx].ns > ns)
+            {
+                ret = idx;
+                ns = slab_[idx].ns;
+            }
+        }
+    }
+    return ret;
+}
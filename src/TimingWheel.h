@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include "TimerQueue.h"
+
+/**
+ * @brief Иерархическое колесо таймеров
+ *
+ * Каждый уровень содержит 64 слота, слот уровня l охватывает 64^l тиков. Задание помещается на
+ * уровень старшей 6-битной группы, в которой его тик отличается от текущего, и опускается на
+ * нижние уровни при переходе текущего тика через границу слота. Вставка, удаление и сработка
+ * выполняются за O(1), пустые слоты пропускаются по битовым маскам занятости.
+ * Порядок сработки заданий внутри одного тика не гарантируется.
+ */
+class TimingWheel final : public ITimerQueue
+{
+public:
+    /**
+     * @brief Параметры колеса
+     *
+     */
+    struct Params
+    {
+        uint64_t tick_ns = 1'000; ///< Разрешение колеса (длительность тика) в наносекундах
+        uint32_t levels = 5;      ///< Количество уровней [1, 10], диапазон колеса tick_ns * 64^levels
+    };
+
+private:
+    static constexpr uint32_t SLOT_BITS = 6;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint32_t MAX_LEVELS = 10;
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node
+    {
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t list = NIL; ///< Номер списка (level * SLOTS + slot), NIL - задание не в очереди
+    };
+
+    TimerSlab &slab_;
+    const uint64_t tick_ns_;
+    const uint32_t levels_;
+    const uint32_t overflow_list_; ///< Список заданий за пределами диапазона колеса
+    std::vector<Node> nodes_; ///< Узлы списков по номеру узла пула
+    std::vector<uint32_t> heads_;
+    std::vector<uint64_t> occupied_; ///< Битовые маски занятых слотов по уровням
+    size_t size_;
+    uint64_t cur_tick_;
+
+public:
+    /**
+     * @brief Конструктор с параметрами
+     *
+     * @param slab Пул заданий, емкость колеса равна его емкости
+     * @param params Параметры колеса
+     * @param start_ns Текущее время в наносекундах (начальная позиция колеса)
+     */
+    TimingWheel(TimerSlab &slab, const Params &params, uint64_t start_ns);
+    bool push(uint32_t slot) override;
+    bool popExpired(uint64_t now_ns, uint32_t &slot) override;
+    bool remove(uint32_t slot) override;
+    bool reschedule(uint32_t slot, uint64_t ns) override;
+    uint64_t nextTime() const override;
+    uint32_t latest() const override;
+    size_t size() const override { return size_; }
+
+private:
+    void place(uint32_t idx);
+    void link(uint32_t idx, uint32_t list);
+    void unlink(uint32_t idx);
+    void cascade();
+    uint64_t nextEventTick(uint32_t &level) const;
+    uint64_t minInList(uint32_t list) const;
+};
@@ -0,0 +1,127 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+class WorkerPool::Worker : public running::IRunnable
+{
+    WorkerPool &pool_;
+
+public:
+    explicit Worker(WorkerPool &pool) : pool_(pool) {}
+    void run(std::atomic_bool &terminate) override { pool_.work(terminate); }
+};
+
+namespace
+{
+    void updateMax(std::atomic<uint64_t> &max, uint64_t v)
+    {
+        uint64_t cur = max.load(std::memory_order_relaxed);
+        while (cur < v && !max.compare_exchange_weak(cur, v, std::memory_order_relaxed))
+        {
+        }
+    }
+} // namespace
+
+WorkerPool::WorkerPool(const Params &params)
+    : queue_(std::max<uint32_t>(params.queue_size, 1)),
+      idle_(0),
+      submitted_(0),
+      executed_(0),
+      rejected_(0),
+      max_depth_(0),
+      max_latency_ns_(0),
+      total_latency_ns_(0)
+{
+    uint32_t workers = std::max<uint32_t>(params.workers, 1);
+    threads_.reserve(workers);
+    for (uint32_t i = 0; i < workers; ++i)
+    {
+        int core_id = params.core_ids.empty() ? -1 : params.core_ids[i % params.core_ids.size()];
+        threads_.push_back(std::make_unique<running::AutoThread>(std::make_unique<Worker>(*this), core_id));
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    for (auto &thr : threads_)
+        thr->terminate();
+    {
+        std::lock_guard lock(mtx_);
+        job_event_.notify_all();
+    }
+    threads_.clear();
+    Job job;
+    while (queue_.tryPop(job))
+        execute(job);
+}
+
+void WorkerPool::submit(AsyncTimerTask::Cb &&cb)
+{
+    Job job{std::move(cb), getTimeNs()};
+    if (!queue_.tryPush(std::move(job)))
+    {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        if (job.cb)
+            job.cb();
+        return;
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    updateMax(max_depth_, queue_.size());
+    // Парный барьер в work(): либо простаивающий поток увидит задание, либо мы увидим его в idle_
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (idle_.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard lock(mtx_);
+        job_event_.notify_one();
+    }
+}
+
+void WorkerPool::execute(Job &job)
+{
+    uint64_t latency = getTimeNs() - job.enqueue_ns;
+    total_latency_ns_.fetch_add(latency, std::memory_order_relaxed);
+    updateMax(max_latency_ns_, latency);
+    if (job.cb)
+        job.cb();
+    executed_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WorkerPool::work(std::atomic_bool &terminate)
+{
+    Job job;
+    while (!terminate.load(std::memory_order_relaxed))
+    {
+        if (queue_.tryPop(job))
+        {
+            execute(job);
+            continue;
+        }
+        std::unique_lock lock(mtx_);
+        idle_.fetch_add(1, std::memory_order_relaxed);
+        // Парный барьер в submit(): задание, не найденное здесь, будит поток через job_event_
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!queue_.tryPop(job))
+        {
+            // Сон без таймаута: остановку будит notify_all деструктора, terminate проверяется под мьютексом
+            if (!terminate.load())
+                job_event_.wait(lock);
+            idle_.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        idle_.fetch_sub(1, std::memory_order_relaxed);
+        lock.unlock();
+        execute(job);
+    }
+}
+
+WorkerPool::Stats WorkerPool::stats() const
+{
+    Stats ret;
+    ret.submitted = submitted_.load(std::memory_order_relaxed);
+    ret.executed = executed_.load(std::memory_order_relaxed);
+    ret.rejected = rejected_.load(std::memory_order_relaxed);
+    ret.depth = queue_.size();
+    ret.max_depth = max_depth_.load(std::memory_order_relaxed);
+    ret.max_latency_ns = max_latency_ns_.load(std::memory_order_relaxed);
+    ret.total_latency_ns = total_latency_ns_.load(std::memory_order_relaxed);
+    return ret;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include "Runnable.h"
+#include "MpmcQueue.h"
+#include "AsyncTimerTask.h"
+
+/**
+ * @brief Пул потоков для асинхронных заданий таймера
+ *
+ * Фиксированное количество потоков (running::AutoThread, с необязательной привязкой к ядрам)
+ * разбирает ограниченную MPMC очередь. Если очередь заполнена, задание выполняется в потоке,
+ * вызвавшем submit().
+ */
+class WorkerPool
+{
+public:
+    /**
+     * @brief Параметры пула
+     *
+     */
+    struct Params
+    {
+        uint32_t workers = 2;        ///< Количество потоков
+        uint32_t queue_size = 1024;  ///< Емкость очереди заданий
+        std::vector<int> core_ids;   ///< Ядра для привязки потоков (по кругу), пусто - без привязки
+    };
+    /**
+     * @brief Счетчики пула
+     *
+     */
+    struct Stats
+    {
+        uint64_t submitted = 0;        ///< Принято заданий в очередь
+        uint64_t executed = 0;         ///< Выполнено заданий потоками пула
+        uint64_t rejected = 0;         ///< Выполнено в вызывающем потоке из-за заполнения очереди
+        uint64_t depth = 0;            ///< Текущая глубина очереди
+        uint64_t max_depth = 0;        ///< Максимальная глубина очереди
+        uint64_t max_latency_ns = 0;   ///< Максимальная задержка от постановки в очередь до запуска
+        uint64_t total_latency_ns = 0; ///< Суммарная задержка от постановки в очередь до запуска
+    };
+
+private:
+    struct Job
+    {
+        AsyncTimerTask::Cb cb;
+        uint64_t enqueue_ns = 0;
+    };
+    class Worker;
+
+    MpmcQueue<Job> queue_;
+    std::mutex mtx_;
+    std::condition_variable job_event_;
+    std::atomic<uint32_t> idle_;
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> executed_;
+    std::atomic<uint64_t> rejected_;
+    std::atomic<uint64_t> max_depth_;
+    std::atomic<uint64_t> max_latency_ns_;
+    std::atomic<uint64_t> total_latency_ns_;
+    std::vector<std::unique_ptr<running::AutoThread>> threads_;
+
+public:
+    /**
+     * @brief Конструктор с параметрами
+     *
+     * @param params Параметры пула
+     */
+    explicit WorkerPool(const Params &params);
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool(WorkerPool &&) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+    WorkerPool &operator=(WorkerPool &&) = delete;
+    /**
+     * @brief Деструктор, останавливает потоки и выполняет оставшиеся задания
+     *
+     */
+    ~WorkerPool();
+    /**
+     * @brief Постановка задания в очередь
+     *
+     * @param cb Задание
+     * Если очередь заполнена, задание выполняется сразу в вызывающем потоке
+     */
+    void submit(AsyncTimerTask::Cb &&cb);
+    /**
+     * @brief Получение счетчиков
+     *
+     * @return Stats
+     */
+    Stats stats() const;
+
+private:
+    void work(std::atomic_bool &terminate);
+    void execute(Job &job);
+};
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <AsyncTimer.h>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+// Цель собирается в C++20: библиотека остается C++17, AsyncTimer.h подключает TimerAwait.h
+#ifndef ASYNC_TIMER_COROUTINES
+#error "async_timer_coro_test requires C++20 coroutines"
+#endif
+
+using namespace std::chrono_literals;
+
+class AsyncTimerTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+};
+
+namespace
+{
+    // Сопрограмма без результата, запускается сразу и не ожидает завершения
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    Detached sleepTask(AsyncTimer &at, uint64_t ns, std::stop_token token, std::atomic<int> &result)
+    {
+        bool slept = co_await sleepFor(at, ns, token);
+        result = slept ? 1 : 2;
+    }
+
+    Detached untilTask(AsyncTimer &at, uint64_t deadline_ns, std::atomic<int> &result)
+    {
+        bool slept = co_await sleepUntil(at, deadline_ns);
+        result = slept ? 1 : 2;
+    }
+
+    Detached timeoutTask(AsyncTimer &at, uint64_t sleep_ns, uint64_t timeout_ns, std::atomic<int> &result)
+    {
+        std::stop_source stop;
+        bool slept = co_await withTimeout(at, timeout_ns, stop, [&at, sleep_ns](std::stop_token token)
+                                          { return sleepFor(at, sleep_ns, token); });
+        // По истечении времени останавливается источник вызывающего
+        result = slept ? 1 : (stop.stop_requested() ? 2 : 3);
+    }
+
+    bool waitResult(const std::atomic<int> &result, std::chrono::milliseconds timeout)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (!result && std::chrono::steady_clock::now() - start < timeout)
+            std::this_thread::sleep_for(1ms);
+        return result != 0;
+    }
+} // namespace
+
+TEST_F(AsyncTimerTest, test_coroutines)
+{
+    AsyncTimer at(16, 1'000'000'000);
+    running::AutoThread thr(&at);
+    std::this_thread::sleep_for(10ms);
+    std::atomic<int> slept{0}, cancelled{0}, early{0}, timed_out{0}, in_time{0}, until{0};
+    uint64_t start = getTimeNs();
+    sleepTask(at, 10'000'000, {}, slept);
+    untilTask(at, at.now() + 5'000'000, until);
+    std::stop_source stop;
+    sleepTask(at, 10'000'000'000, stop.get_token(), cancelled);
+    std::stop_source stopped;
+    stopped.request_stop();
+    sleepTask(at, 10'000'000'000, stopped.get_token(), early);
+    ASSERT_EQ(early, 2);
+    timeoutTask(at, 10'000'000'000, 20'000'000, timed_out);
+    timeoutTask(at, 5'000'000, 1'000'000'000, in_time);
+    ASSERT_TRUE(waitResult(slept, 1s));
+    ASSERT_EQ(slept, 1);
+    ASSERT_GE(getTimeNs() - start, 10'000'000u);
+    ASSERT_EQ(cancelled, 0);
+    stop.request_stop();
+    ASSERT_EQ(cancelled, 2);
+    ASSERT_TRUE(waitResult(timed_out, 1s));
+    ASSERT_EQ(timed_out, 2);
+    ASSERT_TRUE(waitResult(in_time, 1s));
+    ASSERT_EQ(in_time, 1);
+    ASSERT_TRUE(waitResult(until, 1s));
+    ASSERT_EQ(until, 1);
+}
@@ -1,9 +1,42 @@
 #include <gtest/gtest.h>
 #include <gtest/internal/gtest-internal.h>
 #include <AsyncTimer.h>
+#include <ShardedAsyncTimer.h>
+#include <LocalTimer.h>
 #include <chrono>
 #include <thread>
 #include <random>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+// Подсчет выделений памяти в куче для проверки отсутствия аллокаций при создании таймеров. Заменяются все
+// парные формы new/delete; без встраивания GCC не сопоставляет malloc/free с new/delete (-Wmismatched-new-delete)
+#if defined(__GNUC__)
+#define TEST_NOINLINE [[gnu::noinline]]
+#else
+#define TEST_NOINLINE
+#endif
+static std::atomic<uint64_t> g_allocations{0};
+static void *countedAlloc(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+TEST_NOINLINE void *operator new(size_t size) { return countedAlloc(size); }
+TEST_NOINLINE void *operator new[](size_t size) { return countedAlloc(size); }
+TEST_NOINLINE void operator delete(void *p) noexcept { std::free(p); }
+TEST_NOINLINE void operator delete[](void *p) noexcept { std::free(p); }
+TEST_NOINLINE void operator delete(void *p, size_t) noexcept { std::free(p); }
+TEST_NOINLINE void operator delete[](void *p, size_t) noexcept { std::free(p); }
 
 #define TASK(N, T) []() { std::cout << "OnTimer" #N " time " #T << std::endl; }
 using namespace std::chrono_literals;
@@ -159,6 +192,312 @@ TEST_F(AsyncTimerTest, test_async)
     std::cout << "MAX_DELAY:" << at.maxDelay() << std::endl;
 }
 
+TEST_F(AsyncTimerTest, test_async_pool)
+{
+    const uint32_t max_tasks = 100'000;
+    std::atomic<uint32_t> fired{0};
+    AsyncTimer at(max_tasks, 1);
+    ASSERT_TRUE(at.setWorkerPool({2, 1024, {}}));
+    {
+        running::AutoThread thr(&at);
+        std::this_thread::sleep_for(100ms);
+        // Цикл проверки передает задания в пул без мьютекса, поэтому пул не заменяется
+        ASSERT_FALSE(at.setWorkerPool({4, 1024, {}}));
+        for (uint32_t i = 0; i < max_tasks; ++i)
+            ASSERT_TRUE(at.createNanoTimer(1'000 + i % 1'000, [&fired]()
+                                           { fired++; },
+                                           true)
+                            .id);
+        std::this_thread::sleep_for(1s);
+    }
+    auto stats = at.workerPoolStats();
+    std::cout << "SUBMITTED:" << stats.submitted << " REJECTED:" << stats.rejected << " MAX_DEPTH:" << stats.max_depth
+              << " MAX_LATENCY:" << stats.max_latency_ns << std::endl;
+    ASSERT_EQ(fired.load(), max_tasks);
+    ASSERT_EQ(stats.submitted + stats.rejected, max_tasks);
+    ASSERT_LE(stats.max_depth, 1024u);
+}
+
+TEST_F(AsyncTimerTest, test_multi_producer)
+{
+    const uint32_t producers = 16;
+    const uint32_t timers_per_producer = 20'000;
+    const uint32_t max_tasks = producers * timers_per_producer;
+    std::atomic<uint32_t> created{0};
+    std::atomic<uint32_t> fired{0};
+    AsyncTimer at(max_tasks, 1);
+    {
+        running::AutoThread thr(&at);
+        std::this_thread::sleep_for(100ms);
+        std::vector<std::thread> threads;
+        auto start = getTimeNs();
+        for (uint32_t p = 0; p < producers; ++p)
+            threads.emplace_back([&, p]()
+                                 {
+                                     for (uint32_t i = 0; i < timers_per_producer; ++i)
+                                         if (at.createNanoTimer(1'000'000 + (p * timers_per_producer + i) % 100'000, [&fired]()
+                                                                { fired++; })
+                                                 .id)
+                                             created++; });
+        for (auto &t : threads)
+            t.join();
+        auto elapsed = getTimeNs() - start;
+        std::cout << "CREATE " << max_tasks << " timers from " << producers << " threads: " << elapsed << " ns ("
+                  << max_tasks * 1'000'000'000ull / std::max<uint64_t>(elapsed, 1) << " timers/s)" << std::endl;
+        std::this_thread::sleep_for(1s);
+    }
+    ASSERT_EQ(created.load(), max_tasks);
+    ASSERT_EQ(fired.load(), max_tasks);
+}
+
+TEST_F(AsyncTimerTest, test_slow_callback)
+{
+    const uint32_t max_tasks = 10;
+    std::atomic_bool started{false};
+    std::atomic_bool release{false};
+    std::atomic_bool finished{false};
+    AsyncTimer at(max_tasks, 1);
+    {
+        running::AutoThread thr(&at);
+        // Обработчик не завершится, пока тест его не отпустит (предел 10 с вместо зависания при ошибке)
+        auto slow = at.createNanoTimer(1'000, [&started, &release, &finished]()
+                                       {
+                                           started = true;
+                                           for (int i = 0; i < 10'000 && !release.load(); ++i)
+                                               std::this_thread::sleep_for(1ms);
+                                           finished = true; });
+        while (!started.load())
+            std::this_thread::sleep_for(1ms);
+        // Задание уже извлечено и выполняется без мьютекса: удалить его нельзя, создание и удаление не ждут
+        ASSERT_FALSE(at.deleteTimer(slow.id));
+        auto info = at.createSecTimer(10, TASK(1, 10));
+        ASSERT_TRUE(info.id);
+        ASSERT_TRUE(at.deleteTimer(info.id));
+        ASSERT_FALSE(finished.load());
+        release = true;
+    }
+    ASSERT_TRUE(finished.load());
+}
+
+TEST_F(AsyncTimerTest, test_sharded)
+{
+    const uint32_t producers = 4;
+    const uint32_t timers_per_producer = 50'000;
+    const uint32_t max_tasks = producers * timers_per_producer;
+    for (uint32_t shards : {1u, producers})
+    {
+        std::atomic<uint32_t> fired{0};
+        std::vector<std::vector<uint64_t>> ids(producers);
+        uint64_t start = 0;
+        {
+            ShardedAsyncTimer::Params params;
+            params.shards = shards;
+            params.max_timers = max_tasks;
+            ShardedAsyncTimer at(params);
+            ASSERT_EQ(at.shards(), shards);
+            std::vector<std::thread> threads;
+            start = getTimeNs();
+            for (uint32_t p = 0; p < producers; ++p)
+                threads.emplace_back([&, p]()
+                                     {
+                                         for (uint32_t i = 0; i < timers_per_producer; ++i)
+                                             ids[p].push_back(at.createNanoTimerByKey(p, 1'000 + i, [&fired]()
+                                                                                      { fired++; })
+                                                                  .id); });
+            for (auto &t : threads)
+                t.join();
+            // Удаление находит шард по id
+            ASSERT_FALSE(at.deleteTimer(ids[0].back() ^ (1ull << 60)));
+            while (fired.load() < max_tasks && getTimeNs() - start < 10'000'000'000)
+                std::this_thread::sleep_for(1ms);
+        }
+        auto elapsed = getTimeNs() - start;
+        std::cout << "SHARDS " << shards << ": " << max_tasks << " timers armed and fired in " << elapsed << " ns ("
+                  << max_tasks * 1'000'000'000ull / std::max<uint64_t>(elapsed, 1) << " timers/s)" << std::endl;
+        ASSERT_EQ(fired.load(), max_tasks);
+    }
+    ShardedAsyncTimer::Params params;
+    params.shards = 2;
+    params.max_timers = 10;
+    ShardedAsyncTimer at(params);
+    auto a = at.createNanoTimerByKey(1, 10'000'000'000, TASK(1, 10));
+    auto b = at.createNanoTimer(10'000'000'000, TASK(2, 10));
+    ASSERT_TRUE(a.id && b.id);
+    ASSERT_TRUE(at.deleteTimer(a.id));
+    ASSERT_TRUE(at.deleteTimer(b.id));
+    ASSERT_FALSE(at.deleteTimer(a.id));
+}
+
+TEST_F(AsyncTimerTest, test_precision_mode)
+{
+    const uint32_t max_tasks = 200;
+    for (uint64_t spin_ns : {0ull, 200'000ull})
+    {
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<unsigned long long> distrib(1'000'000, 20'000'000);
+        AsyncTimer at(max_tasks, 10'000'000);
+        at.setPrecisionMode(spin_ns);
+        {
+            running::AutoThread thr(&at);
+            std::this_thread::sleep_for(10ms);
+            for (uint32_t i = 0; i < max_tasks; ++i)
+            {
+                ASSERT_TRUE(at.createNanoTimer(distrib(gen), {}).id);
+                std::this_thread::sleep_for(100us);
+            }
+            std::this_thread::sleep_for(50ms);
+        }
+        auto stats = at.stats();
+        std::cout << "SPIN " << spin_ns << " ns LATENESS p50:" << stats.lateness.p50 << " p99:" << stats.lateness.p99
+                  << " max:" << stats.lateness.max << std::endl;
+        ASSERT_EQ(stats.lateness.count, max_tasks);
+    }
+}
+
+TEST_F(AsyncTimerTest, test_precision_reschedule)
+{
+    // Окно активного ожидания шире задержки: цикл проверки сразу опрашивает часы до сработки через 2 с
+    AsyncTimer at(4, 10'000'000);
+    at.setPrecisionMode(5'000'000'000);
+    std::atomic_int fired = 0;
+    running::AutoThread thr(&at);
+    std::this_thread::sleep_for(10ms);
+    TimerInfo info = at.createNanoTimer(2'000'000'000, [&fired]() { fired++; });
+    ASSERT_TRUE(info.id);
+    std::this_thread::sleep_for(20ms);
+    // Перенос раньше ожидаемой сработки прерывает активное ожидание, а не ждет исходного срока
+    ASSERT_EQ(at.rescheduleTimer(info.id, 1'000'000).id, info.id);
+    for (int i = 0; i < 1'000 && fired == 0; ++i)
+        std::this_thread::sleep_for(1ms);
+    ASSERT_EQ(fired, 1);
+    ASSERT_LT(at.now(), info.shedule_tm_ns);
+}
+
+TEST_F(AsyncTimerTest, test_timer_slack)
+{
+    const uint32_t max_tasks = 1'000;
+    const uint64_t slack_ns = 4'000'000;
+    uint64_t saved[2] = {};
+    for (int with_slack : {0, 1})
+    {
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<unsigned long long> distrib(1'000'000, 100'000'000);
+        std::vector<TimerInfo> task_ids;
+        std::vector<uint64_t> delays;
+        std::vector<uint64_t> task_stop_times(max_tasks + 1);
+        // Ручные часы: advanceClock выполняет таймеры точно в их время, проходы не зависят от планировщика
+        ManualClock::set(1ull << 30);
+        AsyncTimer at(max_tasks + 1, 1, TimerBackend::Heap, {}, ClockSource::Manual);
+        at.setTimerSlack(with_slack ? slack_ns : 0);
+        for (uint32_t i = 0; i < max_tasks; ++i)
+        {
+            delays.push_back(distrib(gen));
+            task_ids.push_back(at.createNanoTimer(delays.back(), [i, &at, &task_stop_times]()
+                                                  { task_stop_times[i] = at.now(); }));
+        }
+        // Точный таймер в пакете не округляется при ненулевом допуске по умолчанию
+        TimerRequest strict{12'345'678, [&at, &task_stop_times]()
+                            { task_stop_times[max_tasks] = at.now(); },
+                            false, 0};
+        TimerInfo info;
+        ASSERT_EQ(at.createTimers(&strict, 1, &info), 1u);
+        ASSERT_EQ(info.shedule_tm_ns, info.start_tm_ns + 12'345'678);
+        task_ids.push_back(info);
+        ASSERT_EQ(at.advanceClock(200'000'000), max_tasks + 1);
+        std::vector<uint64_t> deadlines;
+        for (uint32_t i = 0; i < max_tasks; ++i)
+        {
+            uint64_t due_ns = task_ids[i].start_tm_ns + delays[i];
+            ASSERT_GE(task_ids[i].shedule_tm_ns, due_ns);
+            ASSERT_LT(task_ids[i].shedule_tm_ns - due_ns, with_slack ? slack_ns : 1);
+            deadlines.push_back(task_ids[i].shedule_tm_ns);
+        }
+        for (uint32_t i = 0; i <= max_tasks; ++i)
+            ASSERT_EQ(task_stop_times[i], task_ids[i].shedule_tm_ns);
+        std::sort(deadlines.begin(), deadlines.end());
+        size_t distinct = std::unique(deadlines.begin(), deadlines.end()) - deadlines.begin();
+        saved[with_slack] = at.stats(true).wakeups_saved;
+        ASSERT_EQ(at.stats().wakeups_saved, 0u);
+        // Без допуска время сработки не сдвигается, совпавшие точные таймеры не учитываются. С допуском
+        // каждая точка сетки 2^21 нс экономит пробуждения всех своих таймеров, кроме одного
+        ASSERT_EQ(saved[with_slack], with_slack ? max_tasks - distinct : 0u);
+    }
+    std::cout << "WAKEUPS SAVED without slack:" << saved[0] << " with slack:" << saved[1] << std::endl;
+    ASSERT_GE(saved[1], max_tasks - 100);
+}
+
+TEST_F(AsyncTimerTest, test_reschedule_slack)
+{
+    // Перенесенный таймер округляется своим допуском, признак округления пересчитывается
+    const uint64_t grid_ns = 1ull << 20;
+    ManualClock::set(1ull << 30);
+    AsyncTimer at(8, 1, TimerBackend::Heap, {}, ClockSource::Manual);
+    at.setTimerSlack(grid_ns);
+    std::vector<uint64_t> rounded, exact;
+    for (uint64_t i = 1; i <= 4; ++i)
+        rounded.push_back(at.createNanoTimer(i * 100'000, {}).id);
+    for (int i = 0; i < 2; ++i)
+        exact.push_back(at.createNanoTimer(500'000, {}).id);
+    // Четыре таймера попадают на одну точку сетки 3 * 2^20 нс
+    for (uint64_t i = 0; i < rounded.size(); ++i)
+    {
+        TimerInfo info = at.rescheduleTimer(rounded[i], 2'100'000 + i * 100'000);
+        ASSERT_EQ(info.id, rounded[i]);
+        ASSERT_EQ(info.shedule_tm_ns, (1ull << 30) + 3 * grid_ns);
+    }
+    // Два таймера переносятся точно на точку сетки: совпадение без округления пробуждений не экономит
+    for (uint64_t id : exact)
+        ASSERT_EQ(at.rescheduleTimer(id, 2 * grid_ns).shedule_tm_ns, (1ull << 30) + 2 * grid_ns);
+    ASSERT_EQ(at.advanceClock(10'000'000), 6u);
+    ASSERT_EQ(at.stats().wakeups_saved, 3u);
+}
+
+#ifdef __linux__
+TEST_F(AsyncTimerTest, test_poll_fd)
+{
+    const uint32_t max_tasks = 100;
+    AsyncTimer at(max_tasks + 2, 1'000'000'000);
+    int fd = at.openPollFd();
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(at.openPollFd(), fd);
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ASSERT_EQ(epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev), 0);
+
+    const auto loop_id = std::this_thread::get_id();
+    std::atomic<uint32_t> fired{0};
+    std::atomic<bool> same_thread{true};
+    auto cb = [&]()
+    {
+        same_thread = same_thread && std::this_thread::get_id() == loop_id;
+        fired++;
+    };
+    TimerInfo late = at.createNanoTimer(1'000'000'000, cb);
+    for (uint32_t i = 0; i < max_tasks; ++i)
+        ASSERT_TRUE(at.createNanoTimer(1'000'000 + i * 10'000, cb).id);
+    // Таймер раньше взведенного из другого потока должен разбудить цикл через eventfd
+    uint64_t early_ns = 0;
+    std::thread producer([&]()
+                         {
+                             std::this_thread::sleep_for(20ms);
+                             early_ns = at.createNanoTimer(5'000'000, cb).shedule_tm_ns; });
+    uint64_t start = getTimeNs();
+    while (fired < max_tasks + 2 && getTimeNs() - start < 3'000'000'000)
+    {
+        if (epoll_wait(ep, &ev, 1, 100) == 1)
+            at.processExpired();
+    }
+    producer.join();
+    close(ep);
+    ASSERT_EQ(fired, max_tasks + 2);
+    ASSERT_TRUE(same_thread);
+    ASSERT_GE(getTimeNs(), late.shedule_tm_ns);
+    ASSERT_NE(early_ns, 0u);
+    ASSERT_LT(at.stats().lateness.max, 100'000'000u);
+}
+#endif
+
 TEST_F(AsyncTimerTest, test_max_tasks)
 {
     const uint32_t max_tasks = 2;
@@ -217,12 +556,823 @@ TEST_F(AsyncTimerTest, test_del_task)
     auto it1 = at.createNanoTimer(1, TASK(1, 1));
     auto it2 = at.createNanoTimer(10, TASK(2, 10));
     auto it3 = at.createNanoTimer(100, TASK(3, 100));
-    at.deleteTimer(it2.id);
+    ASSERT_TRUE(it1.id && it3.id);
+    ASSERT_TRUE(at.deleteTimer(it2.id));
     std::this_thread::sleep_for(1s);
     at.checkTimersNow();
     std::cout << "MAX_DELAY:" << at.maxDelay() << std::endl;
 }
 
+TEST_F(AsyncTimerTest, test_del_100_000)
+{
+    const uint32_t max_tasks = 100'000;
+    std::vector<TimerInfo> task_ids;
+    task_ids.reserve(max_tasks);
+    uint32_t fired = 0;
+    AsyncTimer at(max_tasks, 1);
+    for (uint32_t i = 0; i < max_tasks; ++i)
+        task_ids.push_back(at.createNanoTimer(1'000 + i, [&fired]()
+                                              { fired++; }));
+    auto start = getTimeNs();
+    for (uint32_t i = 0; i < max_tasks; i += 2)
+        ASSERT_TRUE(at.deleteTimer(task_ids[i].id));
+    std::cout << "DELETE " << max_tasks / 2 << " timers: " << getTimeNs() - start << " ns" << std::endl;
+    ASSERT_FALSE(at.deleteTimer(task_ids[0].id));
+    std::this_thread::sleep_for(10ms);
+    at.checkTimersNow();
+    ASSERT_EQ(fired, max_tasks / 2);
+}
+
+TEST_F(AsyncTimerTest, test_stale_id)
+{
+    for (TimerBackend backend : {TimerBackend::Heap, TimerBackend::Wheel})
+    {
+        int fired = 0;
+        AsyncTimer at(1, 1, backend);
+        TimerInfo first = at.createNanoTimer(1'000'000, [&fired]()
+                                             { fired++; });
+        ASSERT_TRUE(at.deleteTimer(first.id));
+        // Узел пула переиспользуется с новым поколением, старый id не действует на новый таймер
+        TimerInfo second = at.createNanoTimer(1'000'000, [&fired]()
+                                              { fired++; });
+        ASSERT_EQ(static_cast<uint32_t>(second.id), static_cast<uint32_t>(first.id));
+        ASSERT_NE(second.id, first.id);
+        ASSERT_FALSE(at.deleteTimer(first.id));
+        ASSERT_FALSE(at.rescheduleTimer(first.id, 1).id);
+        ASSERT_FALSE(at.deleteTimer(second.id + 1));
+        std::this_thread::sleep_for(5ms);
+        at.checkTimersNow();
+        ASSERT_EQ(fired, 1);
+        ASSERT_FALSE(at.deleteTimer(second.id));
+        ASSERT_TRUE(at.createNanoTimer(1'000'000, {}).id);
+    }
+}
+
+namespace
+{
+    template <typename Backend, typename TimerClock = SteadyClock>
+    struct LocalPolicy
+    {
+        static constexpr uint32_t max_timers = 4;
+        static constexpr bool concurrent = false;
+        static constexpr bool stats = false;
+        using Clock = TimerClock;
+        using Queue = Backend;
+    };
+
+    template <typename Backend>
+    void checkLocalPolicy()
+    {
+        std::vector<int> fired;
+        // max_timers конструктора игнорируется, емкость задана политикой
+        BasicAsyncTimer<LocalPolicy<Backend>> at(1'000, 1);
+        std::vector<TimerInfo> task_ids;
+        for (int i = 0; i < 4; ++i)
+            task_ids.push_back(at.createNanoTimer((4 - i) * 1'000'000, [i, &fired]()
+                                                  { fired.push_back(i); }));
+        ASSERT_FALSE(at.createNanoTimer(1'000'000, {}).id);
+        ASSERT_TRUE(at.deleteTimer(task_ids[1].id));
+        ASSERT_EQ(at.rescheduleTimer(task_ids[0].id, 0).id, task_ids[0].id);
+        std::this_thread::sleep_for(10ms);
+        at.checkTimersNow();
+        ASSERT_EQ(fired, (std::vector<int>{0, 3, 2}));
+        ASSERT_EQ(at.stats().lateness.count, 0u);
+        ASSERT_EQ(at.openPollFd(), -1);
+        ASSERT_TRUE(at.createNanoTimer(1'000'000, {}).id);
+    }
+} // namespace
+
+TEST_F(AsyncTimerTest, test_policy)
+{
+    checkLocalPolicy<HeapTimerQueue>();
+    checkLocalPolicy<TimingWheel>();
+}
+
+TEST_F(AsyncTimerTest, test_local_timer)
+{
+    std::vector<int> fired;
+    LocalTimer lt(8, 4);
+    ASSERT_EQ(lt.nextDeadline(), std::numeric_limits<uint64_t>::max());
+    TimerInfo first = lt.createNanoTimer(2'000'000, [&fired]()
+                                         { fired.push_back(1); });
+    TimerInfo periodic = lt.createPeriodicTimer(5'000'000, [&fired]()
+                                                { fired.push_back(2); });
+    ASSERT_EQ(lt.nextDeadline(), first.shedule_tm_ns);
+    // Время задает владелец: до срока ничего не выполняется
+    ASSERT_EQ(lt.poll(first.shedule_tm_ns - 1), 0u);
+    ASSERT_EQ(lt.poll(first.shedule_tm_ns), 1u);
+    ASSERT_EQ(lt.nextDeadline(), periodic.shedule_tm_ns);
+    TimerInfo posted;
+    std::thread([&lt, &fired, &posted]()
+                { posted = lt.post(1'000'000, [&fired]()
+                                   { fired.push_back(3); }); })
+        .join();
+    ASSERT_TRUE(posted.id);
+    ASSERT_EQ(lt.nextDeadline(), posted.shedule_tm_ns);
+    ASSERT_EQ(lt.size(), 2u);
+    ASSERT_EQ(lt.poll(periodic.shedule_tm_ns), 2u);
+    ASSERT_EQ(fired, (std::vector<int>{1, 3, 2}));
+    ASSERT_TRUE(lt.deleteTimer(periodic.id));
+    ASSERT_FALSE(lt.deleteTimer(posted.id));
+    ASSERT_EQ(lt.size(), 0u);
+    LocalTimer no_inbox(1);
+    ASSERT_FALSE(no_inbox.post(1, {}).id);
+}
+
+TEST_F(AsyncTimerTest, test_cancel_group)
+{
+    for (TimerBackend backend : {TimerBackend::Heap, TimerBackend::Wheel})
+    {
+        const uint64_t sessions = 100;
+        std::vector<uint64_t> fired;
+        AsyncTimer at(4 * sessions, 1, backend);
+        for (uint64_t s = 1; s <= sessions; ++s)
+            for (uint64_t t = 0; t < 3; ++t)
+                ASSERT_TRUE(at.createGroupTimer(s, (t + 1) * 1'000'000, [s, &fired]()
+                                                { fired.push_back(s); })
+                                .id);
+        TimerRequest req;
+        req.ns = 1'000'000;
+        req.group = 7;
+        TimerInfo info;
+        ASSERT_EQ(at.createTimers(&req, 1, &info), 1u);
+        ASSERT_TRUE(at.createPeriodicTimer(500'000, {}, PeriodicPolicy::FixedRate, 8).id);
+        ASSERT_EQ(at.cancelGroup(7), 4u);
+        ASSERT_EQ(at.cancelGroup(7), 0u);
+        ASSERT_FALSE(at.deleteTimer(info.id));
+        ASSERT_EQ(at.cancelGroup(8), 4u);
+        ASSERT_EQ(at.cancelGroup(12345), 0u);
+        ASSERT_EQ(at.cancelGroup(0), 0u);
+        // Нечетные сессии закрыты до сработки
+        for (uint64_t s = 1; s <= sessions; s += 2)
+        {
+            if (s != 7)
+            {
+                ASSERT_EQ(at.cancelGroup(s), 3u);
+            }
+        }
+        std::this_thread::sleep_for(5ms);
+        at.checkTimersNow();
+        ASSERT_EQ(fired.size(), 3 * (sessions / 2 - 1)); // без группы 8
+        for (uint64_t s : fired)
+            ASSERT_EQ(s % 2, 0u);
+        // Сработавшие таймеры покинули группы
+        for (uint64_t s = 2; s <= sessions; s += 2)
+            ASSERT_EQ(at.cancelGroup(s), 0u);
+    }
+}
+
+TEST_F(AsyncTimerTest, test_reschedule)
+{
+    for (TimerBackend backend : {TimerBackend::Heap, TimerBackend::Wheel})
+    {
+        std::vector<int> fired;
+        AsyncTimer at(3, 1, backend);
+        std::vector<TimerInfo> task_ids;
+        for (int i = 0; i < 3; ++i)
+            task_ids.push_back(at.createNanoTimer((i + 1) * 50'000'000, [i, &fired]()
+                                                  { fired.push_back(i); }));
+        TimerInfo later = at.rescheduleTimer(task_ids[0].id, 200'000'000);
+        ASSERT_EQ(later.id, task_ids[0].id);
+        ASSERT_GT(later.shedule_tm_ns, task_ids[2].shedule_tm_ns);
+        ASSERT_EQ(at.rescheduleTimer(task_ids[2].id, 10'000'000).id, task_ids[2].id);
+        ASSERT_EQ(at.rescheduleTimer(12345, 10'000'000).id, 0u);
+        std::this_thread::sleep_for(20ms);
+        at.checkTimersNow();
+        ASSERT_EQ(fired, (std::vector<int>{2}));
+        ASSERT_EQ(at.rescheduleTimer(task_ids[2].id, 10'000'000).id, 0u);
+        std::this_thread::sleep_for(100ms);
+        at.checkTimersNow();
+        ASSERT_EQ(fired, (std::vector<int>{2, 1}));
+        std::this_thread::sleep_for(100ms);
+        at.checkTimersNow();
+        ASSERT_EQ(fired, (std::vector<int>{2, 1, 0}));
+    }
+}
+
+TEST_F(AsyncTimerTest, test_reschedule_order)
+{
+    const uint32_t max_tasks = 1'000;
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<unsigned long long> distrib(1'000'000, 50'000'000);
+    std::uniform_int_distribution<uint32_t> pick(0, max_tasks - 1);
+    std::vector<uint64_t> shedule(max_tasks);
+    std::vector<uint64_t> fired;
+    AsyncTimer at(max_tasks, 1);
+    std::vector<uint64_t> ids;
+    for (uint32_t i = 0; i < max_tasks; ++i)
+    {
+        TimerInfo info = at.createNanoTimer(distrib(gen), [i, &shedule, &fired]()
+                                            { fired.push_back(shedule[i]); });
+        ids.push_back(info.id);
+        shedule[i] = info.shedule_tm_ns;
+    }
+    // Случайные переносы в обе стороны и удаления, порядок сработки должен следовать последним переносам
+    uint32_t deleted = 0;
+    for (uint32_t k = 0; k < 100'000; ++k)
+    {
+        uint32_t i = pick(gen);
+        if (k % 1000 == 0 && at.deleteTimer(ids[i]))
+        {
+            deleted++;
+            continue;
+        }
+        if (TimerInfo info = at.rescheduleTimer(ids[i], distrib(gen)); info.id)
+            shedule[i] = info.shedule_tm_ns;
+    }
+    std::this_thread::sleep_for(100ms);
+    at.checkTimersNow();
+    ASSERT_EQ(fired.size(), max_tasks - deleted);
+    ASSERT_TRUE(std::is_sorted(fired.begin(), fired.end()));
+}
+
+TEST_F(AsyncTimerTest, test_batch)
+{
+    const uint32_t max_tasks = 10'000;
+    for (auto backend : {TimerBackend::Heap, TimerBackend::Wheel})
+    {
+        std::vector<uint64_t> fired;
+        fired.reserve(max_tasks);
+        AsyncTimer at(max_tasks, 1, backend);
+        // Занимает одно место, пакет создается не полностью
+        ASSERT_TRUE(at.createSecTimer(10, TASK(1, 10)).id);
+        std::vector<TimerRequest> timers(max_tasks);
+        for (uint32_t i = 0; i < max_tasks; ++i)
+        {
+            uint64_t ns = (max_tasks - i) * 100;
+            timers[i].ns = ns;
+            timers[i].cb = [ns, &fired]()
+            { fired.push_back(ns); };
+        }
+        std::vector<TimerInfo> infos(max_tasks);
+        ASSERT_EQ(at.createTimers(timers.data(), max_tasks, infos.data()), max_tasks - 1);
+        for (uint32_t i = 1; i < max_tasks - 1; ++i)
+        {
+            ASSERT_NE(infos[i].id, infos[i - 1].id);
+            ASSERT_EQ(infos[i].start_tm_ns, infos[0].start_tm_ns);
+        }
+        ASSERT_FALSE(infos[max_tasks - 1].id);
+        std::vector<uint64_t> ids;
+        for (uint32_t i = 0; i < max_tasks - 1; i += 2)
+            ids.push_back(infos[i].id);
+        ASSERT_EQ(at.deleteTimers(ids.data(), ids.size()), ids.size());
+        ASSERT_EQ(at.deleteTimers(ids.data(), ids.size()), 0u);
+        std::this_thread::sleep_for(10ms);
+        at.checkTimersNow();
+        ASSERT_EQ(fired.size(), max_tasks / 2 - 1);
+        if (backend == TimerBackend::Heap)
+        {
+            ASSERT_TRUE(std::is_sorted(fired.begin(), fired.end()));
+        }
+    }
+}
+
+TEST_F(AsyncTimerTest, test_batch_running)
+{
+    const uint32_t max_tasks = 10'000;
+    std::atomic<uint32_t> fired{0};
+    AsyncTimer at(max_tasks, 1);
+    {
+        running::AutoThread thr(&at);
+        std::this_thread::sleep_for(100ms);
+        std::vector<TimerRequest> timers(max_tasks);
+        for (uint32_t i = 0; i < max_tasks; ++i)
+        {
+            timers[i].ns = 1'000'000 + i;
+            timers[i].cb = [&fired]()
+            { fired++; };
+        }
+        std::vector<TimerInfo> infos(max_tasks);
+        auto start = getTimeNs();
+        ASSERT_EQ(at.createTimers(timers.data(), max_tasks, infos.data()), max_tasks);
+        std::cout << "CREATE BATCH " << max_tasks << " timers: " << getTimeNs() - start << " ns" << std::endl;
+        std::this_thread::sleep_for(100ms);
+    }
+    ASSERT_EQ(fired.load(), max_tasks);
+}
+
+TEST_F(AsyncTimerTest, test_periodic_policy)
+{
+    const uint32_t max_tasks = 10;
+    uint32_t fixed_rate = 0;
+    uint32_t fixed_rate_skip = 0;
+    uint32_t fixed_delay = 0;
+    AsyncTimer at(max_tasks, 1);
+    auto rate = at.createPeriodicTimer(100'000'000, [&fixed_rate]()
+                                       { fixed_rate++; });
+    auto skip = at.createPeriodicTimer(
+        100'000'000, [&fixed_rate_skip]()
+        { fixed_rate_skip++; },
+        PeriodicPolicy::FixedRateSkip);
+    auto delay = at.createPeriodicTimer(
+        100'000'000, [&fixed_delay]()
+        { fixed_delay++; },
+        PeriodicPolicy::FixedDelay);
+    ASSERT_TRUE(rate.id && skip.id && delay.id);
+    ASSERT_FALSE(at.createPeriodicTimer(0, TASK(1, 0)).id);
+    // Пропущено 5 периодов
+    std::this_thread::sleep_for(550ms);
+    at.checkTimersNow();
+    ASSERT_EQ(fixed_rate, 5u);
+    ASSERT_EQ(fixed_rate_skip, 1u);
+    ASSERT_EQ(fixed_delay, 1u);
+    ASSERT_TRUE(at.deleteTimer(rate.id));
+    ASSERT_TRUE(at.deleteTimer(skip.id));
+    ASSERT_TRUE(at.deleteTimer(delay.id));
+    ASSERT_FALSE(at.deleteTimer(delay.id));
+}
+
+TEST_F(AsyncTimerTest, test_periodic_slow_callback)
+{
+    // Задание FixedRate дольше периода: проход выполняет только периоды, истекшие к его началу, и завершается
+    AsyncTimer at(4, 1);
+    uint32_t fired = 0;
+    auto rate = at.createPeriodicTimer(1'000'000, [&fired]()
+                                       {
+                                           fired++;
+                                           std::this_thread::sleep_for(3ms); });
+    ASSERT_TRUE(rate.id);
+    std::this_thread::sleep_for(10ms);
+    at.checkTimersNow();
+    ASSERT_GE(fired, 1u);
+    ASSERT_LE(fired, 20u);
+    // Следующий проход продолжает с пропущенных периодов
+    uint32_t first_pass = fired;
+    at.checkTimersNow();
+    ASSERT_GT(fired, first_pass);
+    ASSERT_TRUE(at.deleteTimer(rate.id));
+    {
+        // Цикл проверки с тем же заданием останавливается по terminate
+        AsyncTimer at_run(4, 1);
+        std::atomic<uint32_t> fired_run{0};
+        ASSERT_TRUE(at_run.createPeriodicTimer(1'000'000, [&fired_run]()
+                                               {
+                                                   fired_run++;
+                                                   std::this_thread::sleep_for(3ms); })
+                        .id);
+        running::AutoThread thr(&at_run);
+        std::this_thread::sleep_for(50ms);
+    }
+}
+
+TEST_F(AsyncTimerTest, test_periodic_running)
+{
+    const uint32_t max_tasks = 10;
+    std::atomic<uint32_t> fired{0};
+    std::atomic<uint64_t> id{0};
+    AsyncTimer at(max_tasks, 1);
+    {
+        running::AutoThread thr(&at);
+        std::this_thread::sleep_for(100ms);
+        auto start = g_allocations.load();
+        // Таймер удаляет сам себя из задания на пятом срабатывании
+        auto info = at.createPeriodicTimer(10'000'000, [&]()
+                                           {
+                                               if (++fired == 5)
+                                               {
+                                                   ASSERT_TRUE(at.deleteTimer(id.load()));
+                                               } });
+        ASSERT_TRUE(info.id);
+        id = info.id;
+        std::this_thread::sleep_for(200ms);
+        ASSERT_EQ(g_allocations.load() - start, 0u);
+    }
+    ASSERT_EQ(fired.load(), 5u);
+}
+
+TEST_F(AsyncTimerTest, test_no_allocations)
+{
+    const uint32_t max_tasks = 10'000;
+    uint64_t sum = 0;
+    for (auto backend : {TimerBackend::Heap, TimerBackend::Wheel})
+    {
+        AsyncTimer at(max_tasks, 1, backend);
+        std::array<uint64_t, 4> payload{1, 2, 3, 4};
+        uint64_t del_id = 0;
+        auto start = g_allocations.load();
+        for (uint32_t i = 0; i < max_tasks; ++i)
+        {
+            auto info = at.createNanoTimer(i, [payload, i, &sum]()
+                                           { sum += payload[i % 4]; });
+            ASSERT_TRUE(info.id);
+            if (i == max_tasks / 2)
+                del_id = info.id;
+        }
+        ASSERT_TRUE(at.deleteTimer(del_id));
+        std::this_thread::sleep_for(1ms);
+        at.checkTimersNow();
+        ASSERT_EQ(g_allocations.load() - start, 0u);
+    }
+    ASSERT_GT(sum, 0u);
+}
+
+TEST_F(AsyncTimerTest, test_clock_source)
+{
+    const uint32_t calls = 1'000'000;
+    const std::pair<ClockSource, const char *> sources[] = {{ClockSource::Steady, "Steady"},
+                                                            {ClockSource::MonotonicCoarse, "MonotonicCoarse"},
+                                                            {ClockSource::Tsc, "Tsc"},
+                                                            {ClockSource::System, "System"}};
+    for (auto [source, name] : sources)
+    {
+        ClockFn now = getClock(source);
+        uint64_t prev = now();
+        bool monotonic = true;
+        auto start = getTimeNs();
+        for (uint32_t i = 0; i < calls; ++i)
+        {
+            uint64_t cur = now();
+            monotonic = monotonic && cur >= prev;
+            prev = cur;
+        }
+        std::cout << "CLOCK " << name << ": " << (getTimeNs() - start) * 1.0 / calls << " ns/call" << std::endl;
+        if (source != ClockSource::System)
+        {
+            ASSERT_TRUE(monotonic);
+            // Монотонные источники имеют общую точку отсчета со steady_clock. Чтение окружено двумя
+            // чтениями steady_clock, поэтому вытеснение потока расширяет окно, а не ломает проверку; допуск
+            // покрывает шаг грубых часов (тик ядра, до 10 мс) и ошибку калибровки TSC
+            const uint64_t tolerance_ns = source == ClockSource::Steady ? 0 : 10'000'000;
+            uint64_t before = getTimeNs(), cur = now(), after = getTimeNs();
+            ASSERT_GE(cur + tolerance_ns, before);
+            ASSERT_LE(cur, after + tolerance_ns);
+        }
+        uint32_t fired = 0;
+        AsyncTimer at(1, 1, TimerBackend::Heap, {}, source);
+        ASSERT_TRUE(at.createNanoTimer(1'000'000, [&fired]()
+                                       { fired++; })
+                        .id);
+        for (int i = 0; i < 10'000 && fired == 0; ++i)
+        {
+            std::this_thread::sleep_for(1ms);
+            at.checkTimersNow();
+        }
+        ASSERT_EQ(fired, 1u);
+    }
+}
+
+TEST_F(AsyncTimerTest, test_histogram)
+{
+    Histogram h;
+    for (uint64_t v = 1; v <= 100'000; ++v)
+        h.record(v);
+    auto snap = h.snapshot();
+    ASSERT_EQ(snap.count, 100'000u);
+    ASSERT_EQ(snap.max, 100'000u);
+    ASSERT_EQ(snap.sum, 5'000'050'000u);
+    // Относительная погрешность не больше 1/32
+    ASSERT_NEAR(snap.p50, 50'000, 50'000 / 32);
+    ASSERT_NEAR(snap.p99, 99'000, 99'000 / 32);
+    ASSERT_NEAR(snap.p999, 99'900, 99'900 / 32);
+    ASSERT_EQ(h.snapshot(true).count, 100'000u);
+    ASSERT_EQ(h.snapshot().count, 0u);
+    ASSERT_EQ(h.max(), 0u);
+    h.record(7, 3);
+    snap = h.snapshot();
+    ASSERT_EQ(snap.count, 3u);
+    ASSERT_EQ(snap.p50, 7u);
+    ASSERT_EQ(snap.p999, 7u);
+}
+
+TEST_F(AsyncTimerTest, test_stats)
+{
+    const uint32_t max_tasks = 100;
+    AsyncTimer at(max_tasks, 1);
+    for (uint32_t i = 0; i < max_tasks; ++i)
+        ASSERT_TRUE(at.createNanoTimer(i * 1'000, []()
+                                       { std::this_thread::sleep_for(100us); })
+                        .id);
+    std::this_thread::sleep_for(10ms);
+    at.checkTimersNow();
+    auto stats = at.stats(true);
+    std::cout << "LATENESS p50:" << stats.lateness.p50 << " p99:" << stats.lateness.p99 << " p99.9:" << stats.lateness.p999
+              << " max:" << stats.lateness.max << std::endl;
+    std::cout << "RUN_TIME p50:" << stats.run_time.p50 << " p99:" << stats.run_time.p99 << " max:" << stats.run_time.max << std::endl;
+    ASSERT_EQ(stats.lateness.count, max_tasks);
+    ASSERT_EQ(stats.run_time.count, max_tasks);
+    ASSERT_GE(stats.run_time.p50, 100'000u);
+    ASSERT_EQ(stats.queue_depth.count, max_tasks);
+    ASSERT_EQ(stats.queue_depth.max, max_tasks);
+    ASSERT_NEAR(stats.queue_depth.p50, max_tasks / 2, 2);
+    ASSERT_EQ(at.stats().lateness.count, 0u);
+    ASSERT_EQ(at.maxDelay(), 0u);
+}
+
+TEST_F(AsyncTimerTest, test_idle_wakeups)
+{
+    AsyncTimer at(10, 1);
+    std::atomic<uint64_t> fired_ns{0};
+    // Пробуждения без уведомления и сработки (ложные пробуждения condition_variable) не зависят от таймера
+    auto woken = [&at]()
+    {
+        auto stats = at.stats();
+        return stats.wakeups - stats.spurious_wakeups;
+    };
+    {
+        running::AutoThread thr(&at);
+        // Пустая очередь: цикл проверки спит без опроса
+        std::this_thread::sleep_for(200ms);
+        ASSERT_EQ(woken(), 0u);
+        TimerInfo info = at.createNanoTimer(20'000'000, [&fired_ns]()
+                                            { fired_ns = getTimeNs(); });
+        at.createNanoTimer(3'600'000'000'000, {});
+        while (fired_ns.load() == 0)
+            std::this_thread::sleep_for(1ms);
+        ASSERT_GE(fired_ns.load(), info.shedule_tm_ns);
+        // После сработки ближнего таймера цикл спит до дальнего
+        uint64_t before = woken();
+        std::this_thread::sleep_for(200ms);
+        auto stats = at.stats();
+        std::cout << "WAKEUPS:" << stats.wakeups << " SPURIOUS:" << stats.spurious_wakeups << std::endl;
+        ASSERT_EQ(woken(), before);
+    }
+}
+
+TEST_F(AsyncTimerTest, test_capacity_growth)
+{
+    const uint32_t max_tasks = 10'000;
+    const uint32_t segment = 1'000; // округляется до 1024
+    for (TimerBackend backend : {TimerBackend::Heap, TimerBackend::Wheel})
+    {
+        AsyncTimer at(max_tasks, 1, backend, {}, ClockSource::Steady, segment);
+        ASSERT_EQ(at.capacity(), 1024u);
+        std::vector<uint64_t> ids;
+        for (uint32_t i = 0; i < 5'000; ++i)
+            ids.push_back(at.createNanoTimer(3'600'000'000'000 + i, {}).id);
+        ASSERT_EQ(std::count(ids.begin(), ids.end(), 0u), 0);
+        ASSERT_EQ(at.capacity(), 5 * 1024u);
+        // Сегмент с активным таймером не освобождается
+        ASSERT_EQ(at.deleteTimers(ids.data(), ids.size() - 1), ids.size() - 1);
+        ASSERT_EQ(at.shrinkCapacity(), 0u);
+        ASSERT_TRUE(at.deleteTimer(ids.back()));
+        ASSERT_EQ(at.shrinkCapacity(), 4 * 1024u);
+        ASSERT_EQ(at.capacity(), 1024u);
+        // Дескрипторы освобожденных узлов не совпадают с новыми таймерами
+        ASSERT_FALSE(at.deleteTimer(ids.back()));
+        for (uint32_t i = 0; i < max_tasks; ++i)
+            ASSERT_TRUE(at.createNanoTimer(3'600'000'000'000, {}).id);
+        ASSERT_EQ(at.capacity(), max_tasks);
+        ASSERT_FALSE(at.createNanoTimer(1, {}).id);
+        ASSERT_FALSE(at.deleteTimer(ids.back()));
+        ASSERT_EQ(at.stats().rejected, 1u);
+    }
+}
+
+TEST_F(AsyncTimerTest, test_overflow_policy)
+{
+    const uint32_t max_tasks = 4;
+    {
+        AsyncTimer at(max_tasks, 1);
+        at.setOverflowPolicy(OverflowPolicy::EvictLatest);
+        std::vector<uint64_t> ids;
+        for (uint32_t i = 1; i <= max_tasks; ++i)
+            ids.push_back(at.createMilliTimer(i * 100, {}).id);
+        // Вытесняется самый поздний таймер, более поздний новый таймер отклоняется
+        ASSERT_TRUE(at.createMilliTimer(50, {}).id);
+        ASSERT_FALSE(at.deleteTimer(ids.back()));
+        ASSERT_FALSE(at.createMilliTimer(1'000, {}).id);
+        ASSERT_TRUE(at.deleteTimer(ids[2]));
+        ASSERT_EQ(at.stats().rejected, 2u);
+    }
+    {
+        // Новый таймер сравнивается с вытесняемым по времени после округления допуском
+        ManualClock::set(1ull << 30);
+        AsyncTimer at(max_tasks, 1, TimerBackend::Heap, {}, ClockSource::Manual);
+        at.setOverflowPolicy(OverflowPolicy::EvictLatest);
+        std::vector<uint64_t> ids;
+        for (uint32_t i = 1; i <= max_tasks; ++i)
+            ids.push_back(at.createMilliTimer(i * 100, {}).id);
+        at.setTimerSlack(1ull << 33);
+        ASSERT_FALSE(at.createMilliTimer(50, {}).id);
+        ASSERT_TRUE(at.deleteTimer(ids.back()));
+        ASSERT_EQ(at.stats().rejected, 1u);
+    }
+    {
+        AsyncTimer at(max_tasks, 1);
+        at.setOverflowPolicy(OverflowPolicy::Block, 1'000'000'000);
+        std::atomic<uint32_t> fired{0};
+        running::AutoThread thr(&at);
+        // Block ждет только при работающем цикле проверки
+        std::this_thread::sleep_for(10ms);
+        for (uint32_t i = 0; i < max_tasks; ++i)
+            ASSERT_TRUE(at.createMilliTimer(20, [&fired]()
+                                            { fired++; })
+                            .id);
+        // Создание ждет сработки таймеров
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_TRUE(at.createMilliTimer(1, [&fired]()
+                                        { fired++; })
+                        .id);
+        ASSERT_GE(std::chrono::steady_clock::now() - start, 10ms);
+        at.setOverflowPolicy(OverflowPolicy::Block, 20'000'000);
+        for (uint32_t i = 0; i < max_tasks; ++i)
+            at.createSecTimer(3'600, {});
+        start = std::chrono::steady_clock::now();
+        ASSERT_FALSE(at.createMilliTimer(1, {}).id);
+        ASSERT_GE(std::chrono::steady_clock::now() - start, 20ms);
+        ASSERT_EQ(fired.load(), max_tasks + 1);
+        ASSERT_EQ(at.stats().rejected, 1u);
+    }
+}
+
+TEST_F(AsyncTimerTest, test_manual_clock)
+{
+    // Час виртуального времени без ожидания: каждое задание выполняется точно в свое время и по порядку
+    const uint32_t max_tasks = 100'000;
+    const uint64_t hour_ns = 3'600'000'000'000;
+    struct State
+    {
+        uint64_t last = 0;
+        uint32_t fired = 0;
+        uint32_t late = 0;
+        uint32_t out_of_order = 0;
+    };
+    for (TimerBackend backend : {TimerBackend::Heap, TimerBackend::Wheel})
+    {
+        ManualClock::set(1'000'000'000);
+        AsyncTimer at(max_tasks + 1, 1, backend, {}, ClockSource::Manual);
+        const uint64_t start = ManualClock::now();
+        std::mt19937_64 gen(1);
+        std::uniform_int_distribution<uint64_t> distrib(1, hour_ns);
+        State state;
+        uint32_t first_half = 0;
+        for (uint32_t i = 0; i < max_tasks; ++i)
+        {
+            uint64_t deadline = start + distrib(gen);
+            first_half += deadline <= start + hour_ns / 2;
+            ASSERT_TRUE(at.createNanoTimer(deadline - start, [&state, deadline]()
+                                           {
+                                               state.late += ManualClock::now() != deadline;
+                                               state.out_of_order += deadline < state.last;
+                                               state.last = deadline;
+                                               state.fired++; })
+                            .id);
+        }
+        uint32_t ticks = 0;
+        ASSERT_TRUE(at.createPeriodicTimer(1'000'000'000, [&ticks]()
+                                           { ticks++; })
+                        .id);
+        auto real_start = std::chrono::steady_clock::now();
+        ASSERT_EQ(at.advanceClock(hour_ns / 2), first_half + 1'800);
+        ASSERT_EQ(ManualClock::now(), start + hour_ns / 2);
+        ASSERT_EQ(at.advanceClock(hour_ns / 2), max_tasks - first_half + 1'800);
+        std::cout << "SIMULATED HOUR " << (backend == TimerBackend::Heap ? "Heap" : "Wheel") << ": "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - real_start).count()
+                  << " ms" << std::endl;
+        ASSERT_EQ(state.fired, max_tasks);
+        ASSERT_EQ(state.late, 0u);
+        ASSERT_EQ(state.out_of_order, 0u);
+        ASSERT_EQ(ticks, 3'600u);
+        ASSERT_EQ(at.stats().lateness.max, 0u);
+        // Колесо возвращает границу тика, не позже следующего периода
+        ASSERT_GT(at.nextDeadline(), start + hour_ns);
+        ASSERT_LE(at.nextDeadline(), start + hour_ns + 1'000'000'000);
+    }
+    {
+        BasicLocalTimer<LocalPolicy<HeapTimerQueue, ManualClock>> lt(16, 16);
+        uint32_t fired = 0;
+        ASSERT_TRUE(lt.createNanoTimer(1'000, [&fired]()
+                                       { fired++; })
+                        .id);
+        ASSERT_TRUE(lt.post(2'000, [&fired]()
+                            { fired++; })
+                        .id);
+        ASSERT_EQ(lt.advanceClock(1'500), 1u);
+        ASSERT_EQ(lt.advanceClock(500), 1u);
+        ASSERT_EQ(fired, 2u);
+    }
+    {
+        // Таймер с другим источником времени не сдвигает общее виртуальное время
+        AsyncTimer at(16, 1);
+        uint64_t manual_ns = ManualClock::now();
+        ASSERT_TRUE(at.createNanoTimer(1'000, []() {}).id);
+        ASSERT_EQ(at.advanceClock(hour_ns), 0u);
+        ASSERT_EQ(ManualClock::now(), manual_ns);
+    }
+}
+
+TEST_F(AsyncTimerTest, test_terminate_wake)
+{
+    // run в собственном потоке: простаивающий цикл спит без таймаута, остановка - флагом и wake()
+    AsyncTimer at(10, 1);
+    std::atomic_bool terminate{false};
+    std::thread thr([&]()
+                    { at.run(terminate); });
+    while (!at.isRunning())
+        std::this_thread::yield();
+    std::this_thread::sleep_for(100ms);
+    terminate = true;
+    at.wake();
+    thr.join();
+    // Единственное пробуждение - от wake()
+    ASSERT_LE(at.stats().wakeups, 1u);
+    ASSERT_EQ(at.stats().spurious_wakeups, 0u);
+}
+
+TEST_F(AsyncTimerTest, test_heap_order)
+{
+    // Случайные вставки, пакеты, удаления и переносы сверяются с отсортированной моделью
+    const uint32_t max_tasks = 1'000;
+    TimerSlab slab(max_tasks);
+    HeapTimerQueue heap(slab);
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<uint64_t> distrib(1, 1'000'000);
+    std::vector<uint32_t> queued;
+    auto add = [&](uint32_t slot)
+    {
+        slab[slot].ns = distrib(gen);
+        queued.push_back(slot);
+    };
+    for (int round = 0; round < 20; ++round)
+    {
+        std::vector<uint32_t> batch;
+        for (uint32_t slot = slab.alloc(); slot != TimerSlab::NIL && batch.size() < 200; slot = slab.alloc())
+        {
+            add(slot);
+            if (round % 2)
+                ASSERT_TRUE(heap.push(slot));
+            else
+                batch.push_back(slot);
+        }
+        ASSERT_EQ(heap.pushBatch(batch.data(), batch.size()), batch.size());
+        std::shuffle(queued.begin(), queued.end(), gen);
+        for (size_t i = 0; i < queued.size() / 4; ++i)
+            ASSERT_TRUE(heap.reschedule(queued[i], distrib(gen)));
+        for (size_t i = 0; i < queued.size() / 8; ++i)
+        {
+            ASSERT_TRUE(heap.remove(queued.back()));
+            ASSERT_FALSE(heap.remove(queued.back()));
+            slab.free(queued.back());
+            queued.pop_back();
+        }
+        ASSERT_EQ(heap.size(), queued.size());
+        uint64_t now_ns = distrib(gen);
+        uint64_t prev_ns = 0;
+        uint32_t slot = 0;
+        while (heap.popExpired(now_ns, slot))
+        {
+            ASSERT_GE(slab[slot].ns, prev_ns);
+            ASSERT_LE(slab[slot].ns, now_ns);
+            prev_ns = slab[slot].ns;
+            queued.erase(std::find(queued.begin(), queued.end(), slot));
+            slab.free(slot);
+        }
+        for (uint32_t q : queued)
+            ASSERT_GT(slab[q].ns, now_ns);
+        ASSERT_EQ(heap.nextTime(), queued.empty() ? std::numeric_limits<uint64_t>::max()
+                                                  : slab[*std::min_element(queued.begin(), queued.end(), [&slab](uint32_t a, uint32_t b)
+                                                                           { return slab[a].ns < slab[b].ns; })]
+                                                        .ns);
+    }
+}
+
+TEST_F(AsyncTimerTest, test_wheel_order)
+{
+    const uint32_t max_tasks = 10;
+    std::vector<int> fired;
+    // диапазон колеса 64^3 тиков по 1 microsec, первый таймер попадает в список переполнения
+    AsyncTimer at(max_tasks, 1, TimerBackend::Wheel, {1'000, 3});
+    const uint64_t delays[] = {400'000'000, 50'000'000, 1'000, 5'000'000, 100'000, 70'000'000};
+    std::vector<TimerInfo> task_ids;
+    for (int i = 0; i < 6; ++i)
+        task_ids.push_back(at.createNanoTimer(delays[i], [i, &fired]()
+                                              { fired.push_back(i); }));
+    ASSERT_TRUE(at.deleteTimer(task_ids[5].id));
+    ASSERT_FALSE(at.deleteTimer(task_ids[5].id));
+    std::this_thread::sleep_for(10ms);
+    at.checkTimersNow();
+    ASSERT_EQ(fired, (std::vector<int>{2, 4, 3}));
+    std::this_thread::sleep_for(500ms);
+    at.checkTimersNow();
+    ASSERT_EQ(fired, (std::vector<int>{2, 4, 3, 1, 0}));
+}
+
+TEST_F(AsyncTimerTest, test_wheel10_000)
+{
+    const uint32_t max_tasks = 10'000;
+    std::vector<TimerInfo> task_ids;
+    std::vector<uint64_t> task_stop_times(max_tasks);
+    task_ids.reserve(max_tasks);
+    AsyncTimer at(max_tasks, 1, TimerBackend::Wheel);
+    {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<unsigned long long> distrib(1'000, 2'000'000'000);
+        running::AutoThread thr(&at);
+        std::this_thread::sleep_for(1s);
+        for (uint32_t i = 0; i < max_tasks; ++i)
+        {
+            task_ids.push_back(at.createNanoTimer(distrib(gen), [i, &task_stop_times]()
+                                                  { task_stop_times[i] = getTimeNs(); }));
+            std::this_thread::sleep_for(1000ns);
+        }
+        std::this_thread::sleep_for(3s);
+    }
+    for (uint32_t i = 0; i < max_tasks; ++i)
+        ASSERT_GE(task_stop_times[i], task_ids[i].shedule_tm_ns);
+    std::cout << "MAX_DELAY:" << at.maxDelay() << " MAX_SIZE:" << at.maxSize() << std::endl;
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);